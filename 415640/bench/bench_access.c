@@ -0,0 +1,71 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_tm.h"
+
+#define ACCESS_CALLS 64        // single-word calls per transaction
+#define ACCESS_TRANSACTIONS 20000
+
+// ns per single-word call, one read-only pass then one read-write pass of reads and writes
+static bool run_alignment(size_t align, unsigned long transactions) {
+    size_t size = ACCESS_CALLS * align;
+    shared_t shared = tm_create(size, align);
+    if (shared == invalid_shared) {
+        fprintf(stderr, "access: tm_create failed for align %zu\n", align);
+        return false;
+    }
+    char* base = tm_start(shared);
+    char* word = aligned_alloc(align, align);
+    if (word == NULL) {
+        tm_destroy(shared);
+        return false;
+    }
+    for (size_t i = 0; i < align; i++) word[i] = (char)i;
+
+    bool ok = true;
+    uint64_t start = bench_now_ns();
+    for (unsigned long t = 0; ok && t < transactions; t++) {
+        tx_t tx = tm_begin(shared, true);
+        for (size_t i = 0; ok && i < ACCESS_CALLS; i++) {
+            ok = tm_read(shared, tx, base + i * align, align, word);
+        }
+        ok = ok && tm_end(shared, tx);
+    }
+    uint64_t ro = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (unsigned long t = 0; ok && t < transactions; t++) {
+        tx_t tx = tm_begin(shared, false);
+        for (size_t i = 0; ok && i < ACCESS_CALLS; i++) {
+            ok = tm_write(shared, tx, word, align, base + i * align);
+        }
+        for (size_t i = 0; ok && i < ACCESS_CALLS; i++) {
+            ok = tm_read(shared, tx, base + i * align, align, word);
+        }
+        ok = ok && tm_end(shared, tx);
+    }
+    uint64_t rw = bench_now_ns() - start;
+
+    free(word);
+    tm_destroy(shared);
+    if (!ok) {
+        fprintf(stderr, "access: unexpected abort for align %zu\n", align);
+        return false;
+    }
+    double calls = (double)transactions * ACCESS_CALLS;
+    printf("%-8zu %11.2f ns %11.2f ns\n", align, (double)ro / calls, (double)rw / (2 * calls));
+    return true;
+}
+
+int bench_access(int argc, char** argv) {
+    unsigned long transactions = bench_arg(argc, argv, 1, ACCESS_TRANSACTIONS);
+
+    // 128 has no specialized instantiation and shows the generic path
+    static const size_t alignments[] = { 8, 16, 32, 64, 128 };
+    printf("%-8s %14s %14s\n", "align", "ro read", "rw access");
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(alignments) / sizeof(alignments[0]); i++) {
+        ok &= run_alignment(alignments[i], transactions);
+    }
+    return ok ? 0 : 1;
+}
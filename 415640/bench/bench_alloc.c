@@ -0,0 +1,103 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "bench_tm.h"
+
+#define ALLOC_TX_PER_THREAD 20000
+#define ALLOC_PER_TX 4
+
+typedef struct {
+    shared_t shared;
+    unsigned long tx_count;
+    unsigned long allocs;
+    unsigned long aborts;
+    bool ok;
+    void** live;        // segments of the last committed transaction of the thread
+    unsigned long live_count;
+} alloc_args_t;
+
+// One transaction allocating fresh segments and writing their first word, then freeing the
+// segments of the previous one so that memory stays bounded, false if it aborted
+static bool alloc_tx(alloc_args_t* args, long value) {
+    void* fresh[args->allocs];
+    tx_t tx = tm_begin(args->shared, false);
+    for (unsigned long a = 0; a < args->allocs; a++) {
+        alloc_t result = tm_alloc(args->shared, tx, 2 * BENCH_ALIGN, &fresh[a]);
+        if (result != success_alloc) {
+            args->ok = result == abort_alloc;
+            return false;
+        }
+        if (!tm_write(args->shared, tx, &value, sizeof(long), fresh[a])) return false;
+    }
+    for (unsigned long a = 0; a < args->live_count; a++) {
+        if (!tm_free(args->shared, tx, args->live[a])) {
+            args->ok = false;
+            return false;
+        }
+    }
+    // only lock table collisions with other threads can abort the commit
+    if (!tm_end(args->shared, tx)) return false;
+    for (unsigned long a = 0; a < args->allocs; a++) args->live[a] = fresh[a];
+    args->live_count = args->allocs;
+    return true;
+}
+
+static void* alloc_thread(void* arg) {
+    alloc_args_t* args = (alloc_args_t*)arg;
+    for (unsigned long t = 0; args->ok && t < args->tx_count; t++) {
+        while (args->ok && !alloc_tx(args, (long)t)) {
+            args->aborts++;
+        }
+    }
+    return NULL;
+}
+
+// Commit throughput of 'threads' threads allocating concurrently, 0 on failure
+static double run_threads(unsigned int threads, unsigned long tx_per_thread, unsigned long allocs, double* aborts_per_tx) {
+    shared_t shared = tm_create(BENCH_ALIGN, BENCH_ALIGN);
+    if (shared == invalid_shared) {
+        return 0;
+    }
+    pthread_t tids[threads];
+    alloc_args_t args[threads];
+    void* live[threads][allocs];
+    uint64_t start = bench_now_ns();
+    for (unsigned int t = 0; t < threads; t++) {
+        args[t] = (alloc_args_t){ shared, tx_per_thread, allocs, 0, true, live[t], 0 };
+        pthread_create(&tids[t], NULL, alloc_thread, &args[t]);
+    }
+    bool ok = true;
+    unsigned long aborts = 0;
+    for (unsigned int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+        ok &= args[t].ok;
+        aborts += args[t].aborts;
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    tm_destroy(shared); // frees every committed segment
+    if (!ok) {
+        return 0;
+    }
+    *aborts_per_tx = (double)aborts / ((double)threads * (double)tx_per_thread);
+    return (double)threads * (double)tx_per_thread / ((double)elapsed / 1e3);
+}
+
+int bench_alloc(int argc, char** argv) {
+    unsigned int max_threads = bench_arg(argc, argv, 1, 2 * bench_default_threads());
+    unsigned long tx_per_thread = bench_arg(argc, argv, 2, ALLOC_TX_PER_THREAD);
+    unsigned long allocs = bench_arg(argc, argv, 3, ALLOC_PER_TX);
+
+    printf("%lu tx/thread, %lu allocations/tx\n", tx_per_thread, allocs);
+    printf("%-8s %14s %14s\n", "threads", "commits", "aborts");
+    for (unsigned int threads = 1; threads <= max_threads; threads *= 2) {
+        double aborts_per_tx = 0;
+        double throughput = run_threads(threads, tx_per_thread, allocs, &aborts_per_tx);
+        if (throughput == 0) {
+            fprintf(stderr, "alloc: failed with %u threads\n", threads);
+            return 1;
+        }
+        printf("%-8u %9.3f Mtx/s %8.4f /tx\n", threads, throughput, aborts_per_tx);
+    }
+    return 0;
+}
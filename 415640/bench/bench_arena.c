@@ -0,0 +1,96 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_tm.h"
+
+#define ARENA_WORDS_MAX 65536
+#define ARENA_ROUNDS 8
+
+// Counting wrappers around the glibc allocator. Defining them in the benchmark binary
+// interposes them for the TM library too; they only count while 'counting' is set.
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void* __libc_memalign(size_t align, size_t size);
+
+static bool counting = false;
+static unsigned long allocations = 0;
+
+void* malloc(size_t size) {
+    allocations += counting;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    allocations += counting;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    allocations += counting;
+    return __libc_realloc(ptr, size);
+}
+
+void* aligned_alloc(size_t align, size_t size) {
+    allocations += counting;
+    return __libc_memalign(align, size);
+}
+
+int posix_memalign(void** ptr, size_t align, size_t size) {
+    allocations += counting;
+    *ptr = __libc_memalign(align, size);
+    return *ptr == NULL ? 12 /* ENOMEM */ : 0;
+}
+
+// Allocations and teardown cost of transactions writing 'words' words. A conflicting commit
+// makes the final read abort, so its cost is dominated by releasing the write set.
+static bool run_writes(size_t words, double* mallocs, double* teardown_ns) {
+    shared_t shared = tm_create((words + 1) * sizeof(long), sizeof(long));
+    if (shared == invalid_shared) {
+        return false;
+    }
+    long* base = tm_start(shared);
+    long value = 1;
+    uint64_t teardown = 0;
+    unsigned long counted = 0;
+    bool ok = true;
+    for (int round = 0; ok && round <= ARENA_ROUNDS; round++) {
+        // the first round warms the reused descriptors up, it is not measured
+        unsigned long before = allocations;
+        counting = round > 0;
+        tx_t tx = tm_begin(shared, false);
+        for (size_t i = 0; i < words; i++) {
+            ok &= tm_write(shared, tx, &value, sizeof(long), base + i);
+        }
+        counting = false;
+        counted += allocations - before;
+
+        tx_t other = tm_begin(shared, false);
+        ok &= tm_write(shared, other, &value, sizeof(long), base + words);
+        ok &= tm_end(shared, other);
+
+        uint64_t start = bench_now_ns();
+        ok &= !tm_read(shared, tx, base + words, sizeof(long), &value);
+        if (round > 0) teardown += bench_now_ns() - start;
+    }
+    tm_destroy(shared);
+    *mallocs = (double)counted / ARENA_ROUNDS;
+    *teardown_ns = (double)teardown / ARENA_ROUNDS;
+    return ok;
+}
+
+int bench_arena(int argc, char** argv) {
+    unsigned long max_words = bench_arg(argc, argv, 1, ARENA_WORDS_MAX);
+
+    printf("%-8s %14s %16s\n", "words", "mallocs/tx", "teardown");
+    bool ok = true;
+    for (unsigned long words = 16; words <= max_words; words *= 4) {
+        double mallocs = 0, teardown = 0;
+        ok &= run_writes(words, &mallocs, &teardown);
+        printf("%-8lu %14.1f %13.1f us\n", words, mallocs, teardown / 1e3);
+    }
+    if (!ok) {
+        fprintf(stderr, "arena: unexpected transaction outcome\n");
+    }
+    return ok ? 0 : 1;
+}
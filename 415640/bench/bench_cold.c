@@ -0,0 +1,68 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_tm.h"
+
+#define COLD_REPEATS 50
+#define COLD_WORDS (1ul << 22)          // words of the region, spread over the whole lock table
+#define COLD_LOCKS (1ul << 24)          // 64 MB lock table
+#define COLD_EVICT (64ul << 20)         // bytes streamed before each commit to evict the caches
+
+// Average ns of a tm_end whose 'words' reads and 'words' writes hit random locks of a cold
+// table, a concurrent commit forcing the validation of the reads
+static double run_cold_commits(size_t words, unsigned long repeats, char* evict, bool* ok) {
+    tm_options_t options;
+    tm_options_default(&options);
+    options.lock_count = COLD_LOCKS;
+    shared_t shared = tm_create_ex(COLD_WORDS * sizeof(long), sizeof(long), &options);
+    if (shared == invalid_shared) {
+        *ok = false;
+        return 0;
+    }
+    long* base = tm_start(shared);
+    unsigned int seed = 1;
+    uint64_t total = 0;
+    for (unsigned long r = 0; *ok && r < repeats; r++) {
+        tx_t tx = tm_begin(shared, false);
+        for (size_t i = 0; i < words; i++) {
+            long value;
+            *ok &= tm_read(shared, tx, base + rand_r(&seed) % COLD_WORDS, sizeof(long), &value);
+            value++;
+            *ok &= tm_write(shared, tx, &value, sizeof(long), base + rand_r(&seed) % COLD_WORDS);
+        }
+        tx_t other = tm_begin(shared, false);
+        long value = (long)r;
+        *ok &= tm_write(shared, other, &value, sizeof(long), base + rand_r(&seed) % COLD_WORDS);
+        *ok &= tm_end(shared, other);
+
+        for (size_t i = 0; i < COLD_EVICT; i += 64) {
+            evict[i]++;
+        }
+        uint64_t start = bench_now_ns();
+        *ok &= tm_end(shared, tx); // the reads collide with the other commit with a tiny probability
+        total += bench_now_ns() - start;
+    }
+    tm_destroy(shared);
+    return (double)total / (double)repeats;
+}
+
+int bench_cold(int argc, char** argv) {
+    unsigned long max_words = bench_arg(argc, argv, 1, 4096);
+    unsigned long repeats = bench_arg(argc, argv, 2, COLD_REPEATS);
+
+    char* evict = calloc(COLD_EVICT, 1);
+    if (evict == NULL) {
+        return 1;
+    }
+    printf("%-8s %14s %14s\n", "words", "tm_end", "per word");
+    bool ok = true;
+    for (size_t words = 4; words <= max_words; words *= 4) {
+        double latency = run_cold_commits(words, repeats, evict, &ok);
+        printf("%-8zu %11.1f us %11.1f ns\n", words, latency / 1e3, latency / (double)words);
+    }
+    free(evict);
+    if (!ok) {
+        fprintf(stderr, "cold: unexpected abort\n");
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_tm.h"
+
+#define COMMIT_TRANSACTIONS 100000
+
+// Average ns of a whole read-write transaction reading then writing 'words' words, and of its tm_end
+static void run_commits(size_t words, unsigned long transactions, double result[2], bool* ok) {
+    shared_t shared = tm_create(BENCH_ACCOUNTS * sizeof(long), sizeof(long));
+    if (shared == invalid_shared) {
+        *ok = false;
+        return;
+    }
+    long* base = tm_start(shared);
+    unsigned int seed = 1;
+    uint64_t total = 0;
+    uint64_t begin = bench_now_ns();
+    for (unsigned long t = 0; *ok && t < transactions; t++) {
+        tx_t tx = tm_begin(shared, false);
+        for (size_t i = 0; i < words; i++) {
+            long* word = base + rand_r(&seed) % BENCH_ACCOUNTS;
+            long value;
+            *ok &= tm_read(shared, tx, word, sizeof(long), &value);
+            value++;
+            *ok &= tm_write(shared, tx, &value, sizeof(long), word);
+        }
+        uint64_t start = bench_now_ns();
+        *ok &= tm_end(shared, tx);
+        total += bench_now_ns() - start;
+    }
+    result[0] = (double)(bench_now_ns() - begin) / (double)transactions;
+    result[1] = (double)total / (double)transactions;
+    tm_destroy(shared);
+}
+
+int bench_commit(int argc, char** argv) {
+    unsigned long transactions = bench_arg(argc, argv, 1, COMMIT_TRANSACTIONS);
+    unsigned long max_words = bench_arg(argc, argv, 2, 1024);
+
+    static const unsigned long sizes[] = { 1, 2, 3, 4, 8, 16, 17, 64, 256, 1024 };
+    printf("%-8s %14s %14s\n", "words", "transaction", "tm_end");
+    bool ok = true;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && sizes[s] <= max_words; s++) {
+        double latency[2] = { 0, 0 };
+        // large transactions are slower, keep their run time comparable
+        run_commits(sizes[s], transactions / sizes[s] + 1, latency, &ok);
+        printf("%-8lu %11.1f ns %11.1f ns\n", sizes[s], latency[0], latency[1]);
+    }
+    if (!ok) {
+        fprintf(stderr, "commit: unexpected abort\n");
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <dict.h>
+#include <dict_chained.h>
+#include "bench_tm.h"
+
+#define DICT_OPS 2000000 // operations per measurement, spread over repeated runs
+
+// Same measurements for both implementations, keys are shuffled word addresses like a TM set
+#define DICT_BENCH(prefix, dict_type) \
+    static void prefix##run(void** keys, void** absent, size_t n, unsigned long runs, double result[5]) { \
+        uint64_t ns[5] = { 0, 0, 0, 0, 0 }; \
+        size_t found = 0; \
+        for (unsigned long r = 0; r < runs; r++) { \
+            uint64_t t0 = bench_now_ns(); \
+            struct dict_type* dic = prefix##new(0); \
+            for (size_t i = 0; i < n; i++) prefix##add(dic, keys[i], 8); \
+            uint64_t t1 = bench_now_ns(); \
+            for (size_t i = 0; i < n; i++) found += prefix##find(dic, keys[i], 8); \
+            uint64_t t2 = bench_now_ns(); \
+            for (size_t i = 0; i < n; i++) found += prefix##find(dic, absent[i], 8); \
+            uint64_t t3 = bench_now_ns(); \
+            prefix##forEach(dic, count_entry, &found); \
+            uint64_t t4 = bench_now_ns(); \
+            prefix##reset(dic); \
+            uint64_t t5 = bench_now_ns(); \
+            prefix##delete(dic); \
+            ns[0] += t1 - t0; ns[1] += t2 - t1; ns[2] += t3 - t2; ns[3] += t4 - t3; ns[4] += t5 - t4; \
+        } \
+        if (found != 2 * n * runs) fprintf(stderr, "dict: %zu lookups out of %zu\n", found, 2 * n * runs); \
+        for (int i = 0; i < 4; i++) result[i] = (double)ns[i] / ((double)runs * (double)n); \
+        result[4] = (double)ns[4] / (double)runs; \
+    }
+
+static int count_entry(void* unused_key, int unused_count, void** unused_value, void* user) {
+    (void)unused_key; (void)unused_count; (void)unused_value;
+    (*(size_t*)user)++;
+    return 1;
+}
+
+DICT_BENCH(dic_, dictionary)
+DICT_BENCH(chained_dic_, chained_dictionary)
+
+int bench_dict(int argc, char** argv) {
+    unsigned long max_keys = bench_arg(argc, argv, 1, 100000);
+    unsigned long ops = bench_arg(argc, argv, 2, DICT_OPS);
+
+    char* region = malloc(16 * max_keys * sizeof(long));
+    void** keys = malloc(max_keys * sizeof(void*));
+    void** absent = malloc(max_keys * sizeof(void*));
+    if (region == NULL || keys == NULL || absent == NULL) {
+        free(region); free(keys); free(absent);
+        return 1;
+    }
+    unsigned int seed = 1;
+    for (unsigned long i = 0; i < max_keys; i++) {
+        keys[i] = region + 16 * i;
+        absent[i] = region + 16 * i + 8;
+    }
+    for (unsigned long i = max_keys - 1; i > 0; i--) {
+        unsigned long j = rand_r(&seed) % (i + 1);
+        void* tmp = keys[i]; keys[i] = keys[j]; keys[j] = tmp;
+    }
+
+    printf("ns per key (per call for reset), swiss table / chained\n");
+    printf("%-8s %18s %18s %18s %18s %18s\n", "keys", "insert", "hit", "miss", "iterate", "reset");
+    static const unsigned long sizes[] = { 1, 4, 16, 64, 256, 1024, 10000, 100000 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && sizes[s] <= max_keys; s++) {
+        size_t n = sizes[s];
+        unsigned long runs = ops / n + 1;
+        double swiss[5], chained[5];
+        dic_run(keys, absent, n, runs, swiss);
+        chained_dic_run(keys, absent, n, runs, chained);
+        printf("%-8zu", n);
+        for (int i = 0; i < 5; i++) printf(" %8.1f / %7.1f", swiss[i], chained[i]);
+        printf("\n");
+    }
+    free(region);
+    free(keys);
+    free(absent);
+    return 0;
+}
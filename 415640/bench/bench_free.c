@@ -0,0 +1,80 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <ll.h>
+#include "bench_tm.h"
+
+#define FREE_BATCH 256 // segments allocated per transaction
+
+// ns per transaction freeing one segment, out of 'count' live ones freed in random order
+static double run_frees(size_t count, void** segments, bool* ok) {
+    shared_t shared = tm_create(BENCH_ALIGN, BENCH_ALIGN);
+    if (shared == invalid_shared) {
+        *ok = false;
+        return 0;
+    }
+    for (size_t i = 0; i < count; i += FREE_BATCH) {
+        tx_t tx = tm_begin(shared, false);
+        for (size_t j = i; j < count && j < i + FREE_BATCH; j++) {
+            *ok &= tm_alloc(shared, tx, 2 * BENCH_ALIGN, &segments[j]) == success_alloc;
+        }
+        *ok &= tm_end(shared, tx);
+    }
+    unsigned int seed = 1;
+    for (size_t i = count - 1; i > 0; i--) {
+        size_t j = rand_r(&seed) % (i + 1);
+        void* tmp = segments[i]; segments[i] = segments[j]; segments[j] = tmp;
+    }
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < count; i++) {
+        tx_t tx = tm_begin(shared, false);
+        *ok &= tm_free(shared, tx, segments[i]) && tm_end(shared, tx);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    tm_destroy(shared);
+    return (double)elapsed / (double)count;
+}
+
+// ns per ll_remove of the same pointers from a list, the lookup a list-based registry needs
+static double run_list_removes(size_t count, void** segments) {
+    ll_t list;
+    ll_init(&list);
+    for (size_t i = 0; i < count; i++) {
+        segments[i] = (char*)NULL + 16 * (i + 1);
+        ll_append(&list, segments[i]);
+    }
+    unsigned int seed = 2;
+    for (size_t i = count - 1; i > 0; i--) {
+        size_t j = rand_r(&seed) % (i + 1);
+        void* tmp = segments[i]; segments[i] = segments[j]; segments[j] = tmp;
+    }
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < count; i++) {
+        ll_remove(&list, segments[i]);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    ll_destroy(&list);
+    return (double)elapsed / (double)count;
+}
+
+int bench_free(int argc, char** argv) {
+    unsigned long max_segments = bench_arg(argc, argv, 1, 65536);
+
+    void** segments = malloc(max_segments * sizeof(void*));
+    if (segments == NULL) {
+        return 1;
+    }
+    printf("%-10s %14s %14s\n", "segments", "tm_free tx", "ll_remove");
+    bool ok = true;
+    for (size_t count = 16; count <= max_segments; count *= 4) {
+        double free_ns = run_frees(count, segments, &ok);
+        double list_ns = run_list_removes(count, segments);
+        printf("%-10zu %11.1f ns %11.1f ns\n", count, free_ns, list_ns);
+    }
+    free(segments);
+    if (!ok) {
+        fprintf(stderr, "free: unexpected failure\n");
+    }
+    return ok ? 0 : 1;
+}
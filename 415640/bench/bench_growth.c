@@ -0,0 +1,102 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <dict.h>
+#include <dict_chained.h>
+#include "bench_tm.h"
+
+#define GROWTH_KEYS 200000 // keys added (words written) per run, enough for several resizes
+#define GROWTH_RUNS 5
+
+static int compare_ns(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Sort the samples and print their percentiles
+static void print_latency(const char* label, uint32_t* ns, size_t n) {
+    qsort(ns, n, sizeof(uint32_t), compare_ns);
+    printf("%-24s %8u %8u %8u %8u %10u\n", label, ns[n / 2], ns[n * 99 / 100], ns[n * 999 / 1000], ns[n * 9999 / 10000], ns[n - 1]);
+}
+
+// Per-call latency of adding fresh keys to an empty dictionary, until n keys
+#define GROWTH_BENCH(prefix, dict_type, setup) \
+    static void prefix##growth(void** keys, size_t n, unsigned long runs, int factor, uint32_t* ns) { \
+        for (unsigned long r = 0; r < runs; r++) { \
+            struct dict_type* dic = prefix##new(0); \
+            setup; \
+            for (size_t i = 0; i < n; i++) { \
+                uint64_t start = bench_now_ns(); \
+                prefix##add(dic, keys[i], 8); \
+                ns[r * n + i] = (uint32_t)(bench_now_ns() - start); \
+            } \
+            prefix##delete(dic); \
+        } \
+        (void)factor; \
+    }
+
+GROWTH_BENCH(dic_, dictionary, dic->growth_factor = factor)
+GROWTH_BENCH(chained_dic_, chained_dictionary, (void)0)
+
+// Per-call latency of tm_write while a single transaction writes n distinct words
+static bool write_growth(size_t n, unsigned long runs, uint32_t* ns) {
+    shared_t shared = tm_create(n * sizeof(long), BENCH_ALIGN);
+    if (shared == invalid_shared) {
+        fprintf(stderr, "growth: tm_create failed\n");
+        return false;
+    }
+    long* base = tm_start(shared);
+    bool ok = true;
+    for (unsigned long r = 0; ok && r < runs; r++) {
+        tx_t tx = tm_begin(shared, false);
+        for (size_t i = 0; ok && i < n; i++) {
+            long value = (long)i;
+            uint64_t start = bench_now_ns();
+            ok = tm_write(shared, tx, &value, sizeof(long), base + i);
+            ns[r * n + i] = (uint32_t)(bench_now_ns() - start);
+        }
+        ok = ok && tm_end(shared, tx);
+    }
+    tm_destroy(shared);
+    if (!ok) fprintf(stderr, "growth: unexpected abort\n");
+    return ok;
+}
+
+int bench_growth(int argc, char** argv) {
+    unsigned long n = bench_arg(argc, argv, 1, GROWTH_KEYS);
+    unsigned long runs = bench_arg(argc, argv, 2, GROWTH_RUNS);
+
+    char* region = malloc(n * sizeof(long));
+    void** keys = malloc(n * sizeof(void*));
+    uint32_t* ns = malloc(n * runs * sizeof(uint32_t));
+    if (region == NULL || keys == NULL || ns == NULL) {
+        free(region); free(keys); free(ns);
+        return 1;
+    }
+    unsigned int seed = 1;
+    for (unsigned long i = 0; i < n; i++) keys[i] = region + i * sizeof(long);
+    for (unsigned long i = n - 1; i > 0; i--) {
+        unsigned long j = rand_r(&seed) % (i + 1);
+        void* tmp = keys[i]; keys[i] = keys[j]; keys[j] = tmp;
+    }
+
+    printf("%lu keys, %lu runs, ns per call\n", n, runs);
+    printf("%-24s %8s %8s %8s %8s %10s\n", "", "p50", "p99", "p99.9", "p99.99", "max");
+    static const int factors[] = { 2, 4, 8 };
+    for (size_t f = 0; f < sizeof(factors) / sizeof(factors[0]); f++) {
+        char label[64];
+        snprintf(label, sizeof(label), "dic_add factor=%d", factors[f]);
+        dic_growth(keys, n, runs, factors[f], ns);
+        print_latency(label, ns, n * runs);
+    }
+    chained_dic_growth(keys, n, runs, 0, ns);
+    print_latency("chained_dic_add", ns, n * runs);
+
+    bool ok = write_growth(n, runs, ns);
+    if (ok) print_latency("tm_write", ns, n * runs);
+
+    free(region);
+    free(keys);
+    free(ns);
+    return ok ? 0 : 1;
+}
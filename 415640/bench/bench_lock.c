@@ -0,0 +1,80 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <version_types.h>
+#include "bench_tm.h"
+
+#define LOCK_OPS_PER_THREAD 200000
+#define LOCK_HOLD_WORK 16 // shared counter increments inside the critical section
+
+typedef struct {
+    bool park;          // park_lock instead of the spinning version_lock
+    version_lock spin_lock;
+    park_lock park_lock;
+    unsigned long ops;
+    volatile unsigned long counter;
+} lock_shared_t;
+
+static void* lock_thread(void* arg) {
+    lock_shared_t* shared = (lock_shared_t*)arg;
+    for (unsigned long i = 0; i < shared->ops; i++) {
+        if (shared->park) {
+            park_lock_acquire(&shared->park_lock);
+        } else {
+            lock_acquire(&shared->spin_lock);
+        }
+        for (int w = 0; w < LOCK_HOLD_WORK; w++) {
+            shared->counter++;
+        }
+        if (shared->park) {
+            park_lock_release(&shared->park_lock);
+        } else {
+            lock_release(&shared->spin_lock);
+        }
+    }
+    return NULL;
+}
+
+// Critical sections per second of 'threads' threads sharing one lock, 0 on a lost update
+static double run_threads(bool park, unsigned int threads, unsigned long ops) {
+    lock_shared_t shared = { .park = park, .ops = ops, .counter = 0 };
+    atomic_init(&shared.spin_lock, 0);
+    atomic_init(&shared.park_lock, 0);
+    pthread_t tids[threads];
+    uint64_t start = bench_now_ns();
+    for (unsigned int t = 0; t < threads; t++) {
+        pthread_create(&tids[t], NULL, lock_thread, &shared);
+    }
+    for (unsigned int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    if (shared.counter != (unsigned long)threads * ops * LOCK_HOLD_WORK) {
+        return 0;
+    }
+    return (double)threads * (double)ops / ((double)elapsed / 1e3);
+}
+
+int bench_lock(int argc, char** argv) {
+    unsigned long ops = bench_arg(argc, argv, 1, LOCK_OPS_PER_THREAD);
+    unsigned int cpus = (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus == 0) {
+        cpus = 1;
+    }
+
+    printf("%lu critical sections/thread, %u CPUs\n", ops, cpus);
+    printf("%-8s %14s %14s\n", "threads", "spin", "spin-park");
+    for (unsigned int factor = 1; factor <= 4; factor *= 2) {
+        unsigned int threads = factor * cpus;
+        double spin = run_threads(false, threads, ops);
+        double park = run_threads(true, threads, ops);
+        if (spin == 0 || park == 0) {
+            fprintf(stderr, "lock: lost update with %u threads\n", threads);
+            return 1;
+        }
+        printf("%-8u %9.3f Mop/s %9.3f Mop/s\n", threads, spin, park);
+    }
+    return 0;
+}
@@ -0,0 +1,158 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "bench_tm.h"
+
+#define INIT_BALANCE 100
+
+typedef struct {
+    shared_t shared;
+    unsigned int thread_id;
+    unsigned long tx_count;
+    unsigned long accounts;
+    unsigned long aborts;
+} transfer_args_t;
+
+// One transfer of a unit between two random accounts, false if the transaction aborted
+static bool transfer(shared_t shared, long* base, unsigned long from, unsigned long to) {
+    tx_t tx = tm_begin(shared, false);
+    if (tx == invalid_tx) {
+        return false;
+    }
+    long from_balance, to_balance;
+    if (!tm_read(shared, tx, base + from, sizeof(long), &from_balance)) return false;
+    if (!tm_read(shared, tx, base + to, sizeof(long), &to_balance)) return false;
+    if (from_balance > 0 && from != to) {
+        from_balance--;
+        to_balance++;
+        if (!tm_write(shared, tx, &from_balance, sizeof(long), base + from)) return false;
+        if (!tm_write(shared, tx, &to_balance, sizeof(long), base + to)) return false;
+    }
+    return tm_end(shared, tx);
+}
+
+static void* transfer_thread(void* arg) {
+    transfer_args_t* args = (transfer_args_t*)arg;
+    long* base = tm_start(args->shared);
+    unsigned int seed = args->thread_id * 2654435761u + 1;
+
+    for (unsigned long i = 0; i < args->tx_count; i++) {
+        unsigned long from = rand_r(&seed) % args->accounts;
+        unsigned long to = rand_r(&seed) % args->accounts;
+        while (!transfer(args->shared, base, from, to)) {
+            args->aborts++;
+        }
+    }
+    return NULL;
+}
+
+// Run the transfer workload on a fresh region, print one result line, false on failure
+static bool run_config(const char* label, tm_options_t const* options, unsigned int threads, unsigned long tx_per_thread, unsigned long accounts) {
+    shared_t shared = tm_create_ex(accounts * sizeof(long), BENCH_ALIGN, options);
+    if (shared == invalid_shared) {
+        fprintf(stderr, "%s: tm_create_ex failed\n", label);
+        return false;
+    }
+
+    // every account starts with the same balance
+    long* base = tm_start(shared);
+    tx_t init = tm_begin(shared, false);
+    for (unsigned long i = 0; i < accounts; i++) {
+        long balance = INIT_BALANCE;
+        tm_write(shared, init, &balance, sizeof(long), base + i);
+    }
+    if (init == invalid_tx || !tm_end(shared, init)) {
+        fprintf(stderr, "%s: initialization failed\n", label);
+        tm_destroy(shared);
+        return false;
+    }
+
+    pthread_t tids[threads];
+    transfer_args_t args[threads];
+    uint64_t start = bench_now_ns();
+    for (unsigned int t = 0; t < threads; t++) {
+        args[t] = (transfer_args_t){ shared, t, tx_per_thread, accounts, 0 };
+        pthread_create(&tids[t], NULL, transfer_thread, &args[t]);
+    }
+    unsigned long aborts = 0;
+    for (unsigned int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+        aborts += args[t].aborts;
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    // money is neither created nor destroyed
+    long sum = 0;
+    tx_t check = tm_begin(shared, true);
+    for (unsigned long i = 0; i < accounts; i++) {
+        long balance = 0;
+        tm_read(shared, check, base + i, sizeof(long), &balance);
+        sum += balance;
+    }
+    tm_end(shared, check);
+    tm_destroy(shared);
+    if (sum != (long)accounts * INIT_BALANCE) {
+        fprintf(stderr, "%s: inconsistent total %ld\n", label, sum);
+        return false;
+    }
+
+    double commits = (double)threads * (double)tx_per_thread;
+    printf("%-28s %10.3f Mtx/s %8.4f aborts/tx %10.1f ns/tx\n", label,
+           commits / ((double)elapsed / 1e3), (double)aborts / commits, (double)elapsed / commits * threads);
+    return true;
+}
+
+int bench_options(int argc, char** argv) {
+    unsigned int threads = bench_arg(argc, argv, 1, bench_default_threads());
+    unsigned long tx_per_thread = bench_arg(argc, argv, 2, BENCH_TX_PER_THREAD);
+    unsigned long accounts = bench_arg(argc, argv, 3, BENCH_ACCOUNTS);
+
+    printf("%u threads, %lu tx/thread, %lu accounts\n", threads, tx_per_thread, accounts);
+
+    tm_options_t defaults;
+    tm_options_default(&defaults);
+    bool ok = run_config("default", &defaults, threads, tx_per_thread, accounts);
+
+    static const size_t lock_counts[] = { 1 << 10, 1 << 16 };
+    for (size_t i = 0; i < sizeof(lock_counts) / sizeof(lock_counts[0]); i++) {
+        tm_options_t options = defaults;
+        options.lock_count = lock_counts[i];
+        char label[64];
+        snprintf(label, sizeof(label), "lock_count=%zu", lock_counts[i]);
+        ok &= run_config(label, &options, threads, tx_per_thread, accounts);
+    }
+
+    static const size_t granularities[] = { 16, 64, 4096 };
+    for (size_t i = 0; i < sizeof(granularities) / sizeof(granularities[0]); i++) {
+        tm_options_t options = defaults;
+        options.lock_granularity = granularities[i];
+        char label[64];
+        snprintf(label, sizeof(label), "lock_granularity=%zu", granularities[i]);
+        ok &= run_config(label, &options, threads, tx_per_thread, accounts);
+    }
+
+    tm_options_t options = defaults;
+    options.backoff = TM_BACKOFF_SPIN;
+    ok &= run_config("backoff=spin", &options, threads, tx_per_thread, accounts);
+    options.backoff = TM_BACKOFF_EXPONENTIAL;
+    ok &= run_config("backoff=exponential", &options, threads, tx_per_thread, accounts);
+
+    options = defaults;
+    options.lock_mapping = TM_LOCK_MAP_STRIPED;
+    ok &= run_config("lock_mapping=striped", &options, threads, tx_per_thread, accounts);
+
+    options = defaults;
+    options.huge_pages = true;
+    ok &= run_config("huge_pages", &options, threads, tx_per_thread, accounts);
+
+    options = defaults;
+    options.stats = true;
+    ok &= run_config("stats", &options, threads, tx_per_thread, accounts);
+
+    options = defaults;
+    options.trace_path = "/tmp/bench_tm_trace.json";
+    ok &= run_config("trace", &options, threads, tx_per_thread, accounts);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_tm.h"
+
+#define READ_REPEATS 2000
+
+// Read the first 'words' words of the region in one call per transaction, ns per word
+static double run_reads(shared_t shared, size_t words, bool read_only, unsigned long repeats, bool* ok) {
+    void* base = tm_start(shared);
+    long* buffer = malloc(words * sizeof(long));
+    if (buffer == NULL) {
+        *ok = false;
+        return 0;
+    }
+    uint64_t start = bench_now_ns();
+    for (unsigned long r = 0; r < repeats; r++) {
+        tx_t tx = tm_begin(shared, read_only);
+        if (tx == invalid_tx || !tm_read(shared, tx, base, words * sizeof(long), buffer) || !tm_end(shared, tx)) {
+            *ok = false;
+            break;
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    free(buffer);
+    return (double)elapsed / ((double)repeats * (double)words);
+}
+
+int bench_read(int argc, char** argv) {
+    unsigned long max_words = bench_arg(argc, argv, 1, 4096);
+    unsigned long repeats = bench_arg(argc, argv, 2, READ_REPEATS);
+
+    printf("%-8s %14s %14s %14s %14s\n", "words", "hashed ro", "striped ro", "hashed rw", "striped rw");
+    bool ok = true;
+    for (unsigned long words = 1; words <= max_words; words *= 4) {
+        double results[4];
+        for (int i = 0; i < 4; i++) {
+            tm_options_t options;
+            tm_options_default(&options);
+            options.lock_mapping = i % 2 == 0 ? TM_LOCK_MAP_HASHED : TM_LOCK_MAP_STRIPED;
+            shared_t shared = tm_create_ex(max_words * sizeof(long), BENCH_ALIGN, &options);
+            if (shared == invalid_shared) {
+                fprintf(stderr, "read: tm_create_ex failed\n");
+                return 1;
+            }
+            // read-write transactions are far slower, keep their run time comparable
+            results[i] = run_reads(shared, words, i < 2, i < 2 ? repeats : repeats / 4 + 1, &ok);
+            tm_destroy(shared);
+        }
+        printf("%-8lu %11.2f ns %11.2f ns %11.2f ns %11.2f ns\n", words, results[0], results[1], results[2], results[3]);
+    }
+    if (!ok) {
+        fprintf(stderr, "read: unexpected abort\n");
+    }
+    return ok ? 0 : 1;
+}
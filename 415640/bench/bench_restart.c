@@ -0,0 +1,60 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_tm.h"
+
+#define RESTART_RETRIES 20000
+
+// Average ns of one aborted attempt of a transaction writing 'words' words then reading a word
+// a concurrent transaction just committed, retried with tm_begin or in place with tm_restart
+static double run_retries(size_t words, bool restart, unsigned long retries, bool* ok) {
+    shared_t shared = tm_create((words + 1) * sizeof(long), sizeof(long));
+    if (shared == invalid_shared) {
+        *ok = false;
+        return 0;
+    }
+    long* base = tm_start(shared);
+    long* conflict = base + words;
+    long value = 1;
+
+    tx_t tx = invalid_tx;
+    uint64_t start = bench_now_ns();
+    for (unsigned long r = 0; r < retries; r++) {
+        if (!restart || tx == invalid_tx || !tm_restart(shared, tx, false)) {
+            tx = tm_begin(shared, false);
+        }
+        for (size_t i = 0; i < words; i++) {
+            tm_write(shared, tx, &value, sizeof(long), base + i);
+        }
+        tx_t other = tm_begin(shared, false);
+        tm_write(shared, other, &value, sizeof(long), conflict);
+        tm_end(shared, other);
+        if (tm_read(shared, tx, conflict, sizeof(long), &value)) {
+            *ok = false; // the snapshot predates the concurrent commit
+            tm_end(shared, tx);
+            break;
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    tm_destroy(shared);
+    return (double)elapsed / (double)retries;
+}
+
+int bench_restart(int argc, char** argv) {
+    unsigned long retries = bench_arg(argc, argv, 1, RESTART_RETRIES);
+    unsigned long max_words = bench_arg(argc, argv, 2, 4096);
+
+    printf("%-8s %14s %14s\n", "words", "tm_begin", "tm_restart");
+    bool ok = true;
+    for (unsigned long words = 1; words <= max_words; words *= 4) {
+        // fewer attempts for large write sets, to keep the run time comparable
+        unsigned long count = retries / words + 16;
+        double begin = run_retries(words, false, count, &ok);
+        double restart = run_retries(words, true, count, &ok);
+        printf("%-8lu %11.0f ns %11.0f ns\n", words, begin, restart);
+    }
+    if (!ok) {
+        fprintf(stderr, "restart: a conflicting read did not abort\n");
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "bench_tm.h"
+
+// Registered benchmarks, run all of them when no name is given
+static const struct {
+    const char* name;
+    bench_func_t func;
+    const char* usage;
+} benchmarks[] = {
+    { "options", bench_options, "[threads] [tx per thread] [accounts]  sweep tm_create_ex options on a transfer workload" },
+    { "read", bench_read, "[max words] [repeats]  per-word cost of one multi-word tm_read, hashed vs striped lock mapping" },
+    { "access", bench_access, "[transactions]  per-call latency of single-word tm_read/tm_write for each alignment" },
+    { "restart", bench_restart, "[retries] [max words]  cost of one aborted attempt, retried with tm_begin vs tm_restart" },
+    { "dict", bench_dict, "[max keys] [operations]  transaction set dictionary vs the former chained table" },
+    { "commit", bench_commit, "[transactions] [max words]  latency of read-write transactions and of their tm_end" },
+    { "arena", bench_arena, "[max words]  allocations and teardown time of large write sets" },
+    { "growth", bench_growth, "[keys] [runs]  per-call latency percentiles of dic_add and tm_write while the sets grow" },
+    { "alloc", bench_alloc, "[max threads] [tx per thread] [allocations per tx]  commit throughput of transactions allocating segments and freeing the previous ones" },
+    { "free", bench_free, "[max segments]  cost of freeing one segment vs the number of live segments" },
+    { "lock", bench_lock, "[ops per thread]  throughput of one contended internal lock at 1x, 2x and 4x the CPUs, spinning vs spin-then-park" },
+    { "validate", bench_validate, "[max words] [repeats]  tm_end latency when every read word was also written and validation runs" },
+    { "cold", bench_cold, "[max words] [repeats]  tm_end latency vs read and write set size with the lock table evicted from the caches" },
+};
+static const int num_benchmarks = sizeof(benchmarks) / sizeof(benchmarks[0]);
+
+uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+unsigned int bench_default_threads(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    // at least two threads so that there is some contention to measure
+    return cpus < 2 ? 2 : (unsigned int)cpus;
+}
+
+unsigned long bench_arg(int argc, char** argv, int index, unsigned long fallback) {
+    if (index >= argc) {
+        return fallback;
+    }
+    return strtoul(argv[index], NULL, 0);
+}
+
+static void usage(const char* self) {
+    printf("Usage: %s [benchmark [args...]]\n", self);
+    for (int i = 0; i < num_benchmarks; i++) {
+        printf("  %-10s %s\n", benchmarks[i].name, benchmarks[i].usage);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        for (int i = 0; i < num_benchmarks; i++) {
+            char* args[] = { (char*)benchmarks[i].name, NULL };
+            printf("=== %s ===\n", benchmarks[i].name);
+            if (benchmarks[i].func(1, args) != 0) {
+                return 1;
+            }
+            printf("\n");
+        }
+        return 0;
+    }
+    for (int i = 0; i < num_benchmarks; i++) {
+        if (strcmp(argv[1], benchmarks[i].name) == 0) {
+            return benchmarks[i].func(argc - 1, argv + 1);
+        }
+    }
+    usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,53 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_tm.h"
+
+#define VALIDATE_REPEATS 200
+
+// Average ns of a tm_end validating 'words' read words that the transaction also wrote,
+// a concurrent commit to another word forcing the validation
+static double run_validations(size_t words, unsigned long repeats, bool* ok) {
+    shared_t shared = tm_create((words + 1) * sizeof(long), sizeof(long));
+    if (shared == invalid_shared) {
+        *ok = false;
+        return 0;
+    }
+    long* base = tm_start(shared);
+    uint64_t total = 0;
+    for (unsigned long r = 0; *ok && r < repeats; r++) {
+        tx_t tx = tm_begin(shared, false);
+        for (size_t i = 0; i < words; i++) {
+            long value;
+            *ok &= tm_read(shared, tx, base + i, sizeof(long), &value);
+            value++;
+            *ok &= tm_write(shared, tx, &value, sizeof(long), base + i);
+        }
+        tx_t other = tm_begin(shared, false);
+        long value = (long)r;
+        *ok &= tm_write(shared, other, &value, sizeof(long), base + words);
+        *ok &= tm_end(shared, other);
+
+        uint64_t start = bench_now_ns();
+        *ok &= tm_end(shared, tx);
+        total += bench_now_ns() - start;
+    }
+    tm_destroy(shared);
+    return (double)total / (double)repeats;
+}
+
+int bench_validate(int argc, char** argv) {
+    unsigned long max_words = bench_arg(argc, argv, 1, 65536);
+    unsigned long repeats = bench_arg(argc, argv, 2, VALIDATE_REPEATS);
+
+    printf("%-8s %14s %14s\n", "words", "tm_end", "per word");
+    bool ok = true;
+    for (size_t words = 16; words <= max_words; words *= 4) {
+        double latency = run_validations(words, repeats, &ok);
+        printf("%-8zu %11.1f us %11.1f ns\n", words, latency / 1e3, latency / (double)words);
+    }
+    if (!ok) {
+        fprintf(stderr, "validate: unexpected abort\n");
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+// Chained hash table that backed the transaction sets before dict.c became a swiss table.
+// Kept only as the baseline of the dict benchmark.
+#include "dict_chained.h"
+#include "stdio.h"
+#include "macros.h"
+
+static inline uint32_t chained_hash_pointer(void *ptr) {
+	//printf("key is %p\n", ptr);fflush(stdout);
+	// Shift out alignment bits to get meaningful variation
+	uintptr_t val = (uintptr_t)ptr >> 3;
+	// Mix the bits to distribute values better in smaller ranges
+	val ^= val >> 16;
+	val *= 0x85ebca6b;
+	val ^= val >> 13;
+	val *= 0xc2b2ae35;
+	val ^= val >> 16;
+	//printf("key %p hashed to value %u\n", ptr, (uint32_t)val);fflush(stdout);
+	return (uint32_t)val;
+}
+
+static struct chained_keynode *chained_keynode_new(void *k) {
+	struct chained_keynode *node = malloc(sizeof(struct chained_keynode));
+	node->key = k;
+	node->next = 0;
+	node->value = NULL;
+	return node;
+}
+
+static void chained_keynode_delete(struct chained_keynode *node) {
+	if (node->next) chained_keynode_delete(node->next);
+	free(node);
+}
+
+struct chained_dictionary* chained_dic_new(int initial_size) {
+	struct chained_dictionary* dic = malloc(sizeof(struct chained_dictionary));
+	if (initial_size == 0) initial_size = 1024;
+	dic->length = initial_size;
+	dic->count = 0;
+	dic->table = calloc(sizeof(struct chained_keynode*), initial_size);
+	dic->growth_treshold = 0.5;
+	dic->growth_factor = 20;
+	return dic;
+}
+
+void chained_dic_delete(struct chained_dictionary* dic) {
+	for (int i = 0; i < dic->length; i++) {
+		if (dic->table[i])
+			chained_keynode_delete(dic->table[i]);
+	}
+	free(dic->table);
+	dic->table = 0;
+	free(dic);
+}
+
+// remove every entry, keeping the table at its current size
+void chained_dic_reset(struct chained_dictionary* dic) {
+	for (int i = 0; i < dic->length; i++) {
+		if (dic->table[i]) {
+			chained_keynode_delete(dic->table[i]);
+			dic->table[i] = 0;
+		}
+	}
+	dic->count = 0;
+}
+
+static void chained_dic_reinsert_when_resizing(struct chained_dictionary* dic, struct chained_keynode *k2) {
+	int n = chained_hash_pointer(k2->key) % dic->length;
+	if (dic->table[n] == 0) {
+		dic->table[n] = k2;
+		dic->value = &dic->table[n]->value;
+		return;
+	}
+	struct chained_keynode *k = dic->table[n];
+	k2->next = k;
+	dic->table[n] = k2;
+	dic->value = &k2->value;
+}
+
+static void chained_dic_resize(struct chained_dictionary* dic, int newsize) {
+	int o = dic->length;
+	struct chained_keynode **old = dic->table;
+	dic->table = calloc(sizeof(struct chained_keynode*), newsize);
+	dic->length = newsize;
+	for (int i = 0; i < o; i++) {
+		struct chained_keynode *k = old[i];
+		while (k) {
+			struct chained_keynode *next = k->next;
+			k->next = 0;
+			chained_dic_reinsert_when_resizing(dic, k);
+			k = next;
+		}
+	}
+	free(old);
+}
+
+int chained_dic_add(struct chained_dictionary* dic, void *key, int unused(keyn)) {
+	int n = chained_hash_pointer(key) % dic->length;
+	if (dic->table[n] == 0) {
+		double f = (double)dic->count / (double)dic->length;
+		if (f > dic->growth_treshold) {
+			chained_dic_resize(dic, dic->length * dic->growth_factor);
+			return chained_dic_add(dic, key, keyn);
+		}
+		dic->table[n] = chained_keynode_new(key);
+		dic->value = &dic->table[n]->value;
+		dic->count++;
+		return 0;
+	}
+	struct chained_keynode *k = dic->table[n];
+	while (k) {
+		if (k->key == key) {
+			dic->value = &k->value;
+			return 1;
+		}
+		k = k->next;
+	}
+	dic->count++;
+	struct chained_keynode *k2 = chained_keynode_new(key);
+	k2->next = dic->table[n];
+	dic->table[n] = k2;
+	dic->value = &k2->value;
+	return 0;
+}
+
+int chained_dic_find(struct chained_dictionary* dic, void *key, int unused(keyn)) {
+	int n = chained_hash_pointer(key) % dic->length;
+    #if defined(__MINGW32__) || defined(__MINGW64__)
+	__builtin_prefetch(gc->table[n]);
+    #endif
+    
+    #if defined(_WIN32) || defined(_WIN64)
+    _mm_prefetch((char*)gc->table[n], _MM_HINT_T0);
+    #endif
+	struct chained_keynode *k = dic->table[n];
+	if (!k) return 0;
+	while (k) {
+		if (k->key == key) {
+			dic->value = &k->value;
+			return 1;
+		}
+		k = k->next;
+	}
+	return 0;
+}
+
+void chained_dic_forEach(struct chained_dictionary* dic, chained_enumFunc f, void *user) {
+	for (int i = 0; i < dic->length; i++) {
+		if (dic->table[i] != 0) {
+			struct chained_keynode *k = dic->table[i];
+			while (k) {
+				if (!f(k->key, k->len, &k->value, user)) return;
+				k = k->next;
+			}
+		}
+	}
+}
+#undef hash_func
\ No newline at end of file
@@ -1,144 +1,369 @@
 #include "dict.h"
 #include "stdio.h"
 #include "macros.h"
+#include <stddef.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
-static inline uint32_t hash_pointer(void *ptr) {
-	//printf("key is %p\n", ptr);fflush(stdout);
+#define DIC_EMPTY ((int8_t)-128)  // control byte of a free slot, full slots are in [0, 127]
+#define DIC_DEFAULT_SIZE 64       // slots of a dictionary created with initial_size 0
+
+static inline uint64_t hash_pointer(void *ptr) {
 	// Shift out alignment bits to get meaningful variation
-	uintptr_t val = (uintptr_t)ptr >> 3;
-	// Mix the bits to distribute values better in smaller ranges
-	val ^= val >> 16;
-	val *= 0x85ebca6b;
-	val ^= val >> 13;
-	val *= 0xc2b2ae35;
-	val ^= val >> 16;
-	//printf("key %p hashed to value %u\n", ptr, (uint32_t)val);fflush(stdout);
-	return (uint32_t)val;
+	uint64_t val = (uintptr_t)ptr >> 3;
+	// Multiplicative mix, folded so that both the low (control byte) and the
+	// high (position) bits depend on every bit of the address
+	val *= 0x9e3779b97f4a7c15ull;
+	val ^= val >> 32;
+	return val;
+}
+
+// bit i set when control byte i of the group starting at ctrl equals byte
+static inline uint32_t group_match(int8_t const *ctrl, int8_t byte) {
+#ifdef __SSE2__
+	__m128i group = _mm_loadu_si128((__m128i const*)ctrl);
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(byte)));
+#else
+	uint32_t mask = 0;
+	for (int i = 0; i < DIC_GROUP; i++)
+		mask |= (uint32_t)(ctrl[i] == byte) << i;
+	return mask;
+#endif
+}
+
+// mark a slot full, a group of an older generation is emptied first
+static inline void set_ctrl(struct dic_table* table, int index, int8_t byte) {
+	int group = index / DIC_GROUP;
+	if (table->group_gen[group] != table->generation) {
+		memset(table->ctrl + group * DIC_GROUP, DIC_EMPTY, DIC_GROUP);
+		table->group_gen[group] = table->generation;
+	}
+	table->ctrl[index] = byte;
+}
+
+static int round_up_pow2(int size) {
+	int length = DIC_GROUP;
+	while (length < size)
+		length *= 2;
+	return length;
 }
 
-struct keynode *keynode_new(void *k) {
-	struct keynode *node = malloc(sizeof(struct keynode));
-	node->key = k;
-	node->next = 0;
-	node->value = NULL;
-	return node;
+// allocate an empty table of length slots
+static int dic_init(struct dic_table* table, int length) {
+	int entries = length - length / 8;
+	int8_t *ctrl = malloc(length);
+	uint16_t *group_gen = calloc(length / DIC_GROUP, sizeof(uint16_t));
+	int32_t *slots = malloc(sizeof(int32_t) * length);
+	void **keys = malloc(sizeof(void*) * entries);
+	HASHDICT_VALUE_TYPE *values = malloc(sizeof(HASHDICT_VALUE_TYPE) * entries);
+	if (unlikely(ctrl == NULL || group_gen == NULL || slots == NULL || keys == NULL || values == NULL)) {
+		free(ctrl);
+		free(group_gen);
+		free(slots);
+		free(keys);
+		free(values);
+		return 0;
+	}
+	table->ctrl = ctrl;
+	table->group_gen = group_gen;
+	table->generation = 1; // every group is stale, so empty
+	table->slots = slots;
+	table->keys = keys;
+	table->values = values;
+	table->length = length;
+	table->growth_limit = entries;
+	return 1;
 }
 
-void keynode_delete(struct keynode *node) {
-	if (node->next) keynode_delete(node->next);
-	free(node);
+static void dic_free_table(struct dic_table* table) {
+	free(table->ctrl);
+	free(table->group_gen);
+	free(table->slots);
+	free(table->keys);
+	free(table->values);
+	memset(table, 0, sizeof(struct dic_table));
 }
 
 struct dictionary* dic_new(int initial_size) {
 	struct dictionary* dic = malloc(sizeof(struct dictionary));
-	if (initial_size == 0) initial_size = 1024;
-	dic->length = initial_size;
-	dic->count = 0;
-	dic->table = calloc(sizeof(struct keynode*), initial_size);
-	dic->growth_treshold = 0.5;
-	dic->growth_factor = 20;
+	if (unlikely(dic == NULL))
+		return NULL;
+	memset(dic, 0, offsetof(struct dictionary, small_keys));
+	// small_find loads keys in pairs, so the key past an odd count is read (and ignored) too
+	memset(dic->small_keys, 0, sizeof(dic->small_keys));
+	dic->growth_factor = DIC_GROWTH_FACTOR;
+	dic->small = true;
+	if (initial_size > DIC_SMALL) {
+		// expected to outgrow the inline arrays, build the table now
+		if (unlikely(!dic_init(&dic->table, round_up_pow2(initial_size)))) {
+			free(dic);
+			return NULL;
+		}
+		dic->small = false;
+	}
 	return dic;
 }
 
 void dic_delete(struct dictionary* dic) {
-	for (int i = 0; i < dic->length; i++) {
-		if (dic->table[i])
-			keynode_delete(dic->table[i]);
+	dic_free_table(&dic->table);
+	dic_free_table(&dic->old);
+	for (struct dic_chunk *chunk = dic->chunks; chunk;) {
+		struct dic_chunk *next = chunk->next;
+		free(chunk);
+		chunk = next;
 	}
-	free(dic->table);
-	dic->table = 0;
 	free(dic);
 }
 
-void dic_reinsert_when_resizing(struct dictionary* dic, struct keynode *k2) {
-	int n = hash_pointer(k2->key) % dic->length;
-	if (dic->table[n] == 0) {
-		dic->table[n] = k2;
-		dic->value = &dic->table[n]->value;
-		return;
-	}
-	struct keynode *k = dic->table[n];
-	k2->next = k;
-	dic->table[n] = k2;
-	dic->value = &k2->value;
-}
-
-void dic_resize(struct dictionary* dic, int newsize) {
-	int o = dic->length;
-	struct keynode **old = dic->table;
-	dic->table = calloc(sizeof(struct keynode*), newsize);
-	dic->length = newsize;
-	for (int i = 0; i < o; i++) {
-		struct keynode *k = old[i];
-		while (k) {
-			struct keynode *next = k->next;
-			k->next = 0;
-			dic_reinsert_when_resizing(dic, k);
-			k = next;
+// index of key in the inline arrays, -1 if absent
+static inline int small_find(struct dictionary* dic, void *key) {
+#ifdef __SSE2__
+	// two keys per compare: both 32-bit halves must match
+	__m128i needle = _mm_set1_epi64x((int64_t)(uintptr_t)key);
+	for (int i = 0; i < dic->count; i += 2) {
+		__m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((__m128i const*)&dic->small_keys[i]), needle);
+		eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+		int mask = _mm_movemask_pd(_mm_castsi128_pd(eq));
+		if (mask) {
+			int index = i + __builtin_ctz(mask);
+			return index < dic->count ? index : -1; // past count is a stale key
 		}
 	}
-	free(old);
+	return -1;
+#else
+	for (int i = 0; i < dic->count; i++)
+		if (dic->small_keys[i] == key) return i;
+	return -1;
+#endif
 }
 
-int dic_add(struct dictionary* dic, void *key, int unused(keyn)) {
-	int n = hash_pointer(key) % dic->length;
-	if (dic->table[n] == 0) {
-		double f = (double)dic->count / (double)dic->length;
-		if (f > dic->growth_treshold) {
-			dic_resize(dic, dic->length * dic->growth_factor);
-			return dic_add(dic, key, keyn);
+// Probe sequence: groups at triangular offsets from the home group, which
+// visits every group of a power of 2 table. The table is never full, so an
+// empty slot ends every probe.
+
+// slot holding key, or the free slot where it belongs (negative, -1 - index)
+static inline int dic_probe(struct dic_table* table, void *key, uint64_t hash) {
+	int8_t h2 = (int8_t)(hash & 0x7f);
+	size_t mask = table->length / DIC_GROUP - 1;
+	size_t group = (hash >> 7) & mask;
+	for (size_t step = 1;; step++) {
+		size_t base = group * DIC_GROUP;
+		if (table->group_gen[group] != table->generation)
+			return -1 - (int)base; // stale, so empty
+		int8_t const *ctrl = table->ctrl + base;
+		for (uint32_t match = group_match(ctrl, h2); match; match &= match - 1) {
+			size_t index = base + __builtin_ctz(match);
+			if (likely(table->keys[table->slots[index]] == key))
+				return (int)index;
 		}
-		dic->table[n] = keynode_new(key);
-		dic->value = &dic->table[n]->value;
-		dic->count++;
-		return 0;
+		uint32_t empty = group_match(ctrl, DIC_EMPTY);
+		if (likely(empty))
+			return -1 - (int)(base + __builtin_ctz(empty));
+		group = (group + step) & mask;
+	}
+}
+
+// index the entries [from, to) of the table arrays
+static void dic_reindex(struct dic_table* table, int from, int to) {
+	for (int i = from; i < to; i++) {
+		uint64_t hash = hash_pointer(table->keys[i]);
+		int index = -1 - dic_probe(table, table->keys[i], hash);
+		set_ctrl(table, index, (int8_t)(hash & 0x7f));
+		table->slots[index] = i;
+	}
+}
+
+// value slot of key in the table or, while migrating, in the old one; NULL if absent
+static inline HASHDICT_VALUE_TYPE *dic_lookup(struct dictionary* dic, void *key, uint64_t hash, int *index) {
+	*index = dic_probe(&dic->table, key, hash);
+	if (*index >= 0)
+		return &dic->table.values[dic->table.slots[*index]];
+	if (dic->migrated < dic->migrate_end) {
+		// a hit in the old index is an entry not migrated yet, the others were found above
+		int old_index = dic_probe(&dic->old, key, hash);
+		if (old_index >= 0)
+			return &dic->old.values[dic->old.slots[old_index]];
+	}
+	return NULL;
+}
+
+// move up to steps entries from the old table, freed once empty
+static void dic_migrate(struct dictionary* dic, int steps) {
+	int end = dic->migrated + steps;
+	if (end > dic->migrate_end) end = dic->migrate_end;
+	memcpy(dic->table.keys + dic->migrated, dic->old.keys + dic->migrated, sizeof(void*) * (end - dic->migrated));
+	memcpy(dic->table.values + dic->migrated, dic->old.values + dic->migrated, sizeof(HASHDICT_VALUE_TYPE) * (end - dic->migrated));
+	dic_reindex(&dic->table, dic->migrated, end);
+	dic->migrated = end;
+	if (end == dic->migrate_end) {
+		dic_free_table(&dic->old);
+		dic->migrated = dic->migrate_end = 0;
+	}
+}
+
+// remove every entry in O(1), keeping the table at its current size and the arena chunks
+void dic_reset(struct dictionary* dic) {
+	dic->count = 0;
+	dic->chunk = dic->chunks;
+	dic->chunk_used = 0;
+	dic->small = true;
+	if (unlikely(dic->migrate_end != 0)) {
+		// abandon the migration, the grown table is kept
+		dic_free_table(&dic->old);
+		dic->migrated = dic->migrate_end = 0;
 	}
-	struct keynode *k = dic->table[n];
-	while (k) {
-		if (k->key == key) {
-			dic->value = &k->value;
+	if (unlikely(++dic->table.generation == 0)) {
+		// stamps would be ambiguous after the wraparound, really clear them (if the table was built)
+		if (dic->table.length != 0)
+			memset(dic->table.group_gen, 0, sizeof(uint16_t) * (dic->table.length / DIC_GROUP));
+		dic->table.generation = 1;
+	}
+}
+
+// move the inline entries to the table, built on first use
+static int dic_promote(struct dictionary* dic) {
+	if (dic->table.length == 0 && unlikely(!dic_init(&dic->table, DIC_DEFAULT_SIZE)))
+		return 0;
+	memcpy(dic->table.keys, dic->small_keys, sizeof(void*) * dic->count);
+	memcpy(dic->table.values, dic->small_values, sizeof(HASHDICT_VALUE_TYPE) * dic->count);
+	dic->small = false;
+	dic_reindex(&dic->table, 0, dic->count);
+	return 1;
+}
+
+// start moving the entries to a table growth_factor times larger, false if out of memory
+static int dic_grow(struct dictionary* dic) {
+	// with the factor clamped to at least 2, a migration moving DIC_MIGRATE_STEP entries per
+	// insertion ends long before the grown table fills up; finish it anyway should that change
+	if (unlikely(dic->migrate_end != 0))
+		dic_migrate(dic, dic->migrate_end);
+	int factor = dic->growth_factor < 2 ? 2 : dic->growth_factor;
+	struct dic_table grown;
+	if (unlikely(!dic_init(&grown, round_up_pow2(dic->table.length * factor))))
+		return 0;
+	dic->old = dic->table;
+	dic->table = grown;
+	dic->migrated = 0;
+	dic->migrate_end = dic->count;
+	return 1;
+}
+
+int dic_add(struct dictionary* dic, void *key, int unused(keyn)) {
+	if (dic->small) {
+		int entry = small_find(dic, key);
+		if (entry >= 0) {
+			dic->value = &dic->small_values[entry];
 			return 1;
 		}
-		k = k->next;
+		if (likely(dic->count < DIC_SMALL)) {
+			entry = dic->count++;
+			dic->small_keys[entry] = key;
+			dic->small_values[entry] = NULL;
+			dic->value = &dic->small_values[entry];
+			return 0;
+		}
+		if (unlikely(!dic_promote(dic)))
+			return -1;
+	}
+	if (unlikely(dic->migrate_end != 0))
+		dic_migrate(dic, DIC_MIGRATE_STEP);
+	uint64_t hash = hash_pointer(key);
+	int index;
+	HASHDICT_VALUE_TYPE *value = dic_lookup(dic, key, hash, &index);
+	if (value != NULL) {
+		dic->value = value;
+		return 1;
 	}
-	dic->count++;
-	struct keynode *k2 = keynode_new(key);
-	k2->next = dic->table[n];
-	dic->table[n] = k2;
-	dic->value = &k2->value;
+	if (unlikely(dic->count >= dic->table.growth_limit)) {
+		if (unlikely(!dic_grow(dic)))
+			return -1;
+		index = dic_probe(&dic->table, key, hash);
+	}
+	index = -1 - index;
+	int entry = dic->count++;
+	set_ctrl(&dic->table, index, (int8_t)(hash & 0x7f));
+	dic->table.slots[index] = entry;
+	dic->table.keys[entry] = key;
+	dic->table.values[entry] = NULL;
+	dic->value = &dic->table.values[entry];
 	return 0;
 }
 
 int dic_find(struct dictionary* dic, void *key, int unused(keyn)) {
-	int n = hash_pointer(key) % dic->length;
-    #if defined(__MINGW32__) || defined(__MINGW64__)
-	__builtin_prefetch(gc->table[n]);
-    #endif
-    
-    #if defined(_WIN32) || defined(_WIN64)
-    _mm_prefetch((char*)gc->table[n], _MM_HINT_T0);
-    #endif
-	struct keynode *k = dic->table[n];
-	if (!k) return 0;
-	while (k) {
-		if (k->key == key) {
-			dic->value = &k->value;
-			return 1;
-		}
-		k = k->next;
+	if (dic->small) {
+		int entry = small_find(dic, key);
+		if (entry < 0) return 0;
+		dic->value = &dic->small_values[entry];
+		return 1;
 	}
-	return 0;
+	int index;
+	HASHDICT_VALUE_TYPE *value = dic_lookup(dic, key, hash_pointer(key), &index);
+	if (value == NULL) return 0;
+	dic->value = value;
+	return 1;
+}
+
+// ahead, if any, gets each key 'distance' entries before f, to start fetching what f will touch
+static inline int dic_forRange(void **keys, HASHDICT_VALUE_TYPE *values, int from, int to, enumFunc f, aheadFunc ahead, int distance, void *user) {
+	if (ahead != NULL) {
+		for (int i = from; i < to && i < from + distance; i++) ahead(keys[i], user);
+	}
+	for (int i = from; i < to; i++) {
+		if (ahead != NULL && i + distance < to) ahead(keys[i + distance], user);
+		if (!f(keys[i], sizeof(void*), &values[i], user)) return 0;
+	}
+	return 1;
+}
+
+// in insertion order, f must not add to dic (a resize would move the entries)
+void dic_forEachAhead(struct dictionary* dic, enumFunc f, aheadFunc ahead, int distance, void *user) {
+	if (distance <= 0) ahead = NULL;
+	if (dic->small) {
+		dic_forRange(dic->small_keys, dic->small_values, 0, dic->count, f, ahead, distance, user);
+		return;
+	}
+	if (dic->migrate_end == 0) {
+		dic_forRange(dic->table.keys, dic->table.values, 0, dic->count, f, ahead, distance, user);
+		return;
+	}
+	// entries not migrated yet are still in the old arrays
+	if (dic_forRange(dic->table.keys, dic->table.values, 0, dic->migrated, f, ahead, distance, user)
+			&& dic_forRange(dic->old.keys, dic->old.values, dic->migrated, dic->migrate_end, f, ahead, distance, user))
+		dic_forRange(dic->table.keys, dic->table.values, dic->migrate_end, dic->count, f, ahead, distance, user);
 }
 
 void dic_forEach(struct dictionary* dic, enumFunc f, void *user) {
-	for (int i = 0; i < dic->length; i++) {
-		if (dic->table[i] != 0) {
-			struct keynode *k = dic->table[i];
-			while (k) {
-				if (!f(k->key, k->len, &k->value, user)) return;
-				k = k->next;
-			}
-		}
+	dic_forEachAhead(dic, f, NULL, 0, user);
+}
+
+void* dic_alloc(struct dictionary* dic, size_t size) {
+	size = (size + 15) & ~(size_t)15;
+	struct dic_chunk *chunk = dic->chunk;
+	if (likely(chunk != NULL && chunk->size - dic->chunk_used >= size)) {
+		void *data = chunk->data + dic->chunk_used;
+		dic->chunk_used += size;
+		return data;
+	}
+	// move to the next retained chunk that fits, dropping the ones too small
+	struct dic_chunk **link = chunk ? &chunk->next : &dic->chunks;
+	while (*link && (*link)->size < size) {
+		struct dic_chunk *small = *link;
+		*link = small->next;
+		free(small);
+	}
+	if (*link == NULL) {
+		size_t chunk_size = chunk ? chunk->size * 2 : DIC_CHUNK_MIN;
+		if (chunk_size > DIC_CHUNK_MAX) chunk_size = DIC_CHUNK_MAX;
+		if (chunk_size < size) chunk_size = size;
+		struct dic_chunk *fresh = malloc(sizeof(struct dic_chunk) + chunk_size);
+		if (unlikely(fresh == NULL))
+			return NULL;
+		fresh->next = NULL;
+		fresh->size = chunk_size;
+		*link = fresh;
 	}
+	dic->chunk = *link;
+	dic->chunk_used = size;
+	return dic->chunk->data;
 }
-#undef hash_func
\ No newline at end of file
@@ -6,88 +6,116 @@ bool ll_init(ll_t *list) {
     if (list == NULL) {
         return false;
     }
-    
+
     list->head = NULL;
     list->tail = NULL;
     list->size = 0;
+    list->spare = NULL;
     atomic_store(&list->lock, 0);  // Initialize lock to unlocked state
-    
+
     return true;
 }
 
-void ll_destroy(ll_t *list) {
-    if (list == NULL) {
-        return;
-    }
-    
-    ll_node_t *current = list->head;
+// Free a chain of nodes, calling destructor (if any) on each element
+static void ll_free_nodes(ll_node_t *current, void (*destructor)(void *)) {
     ll_node_t *next;
-    
+
     while (current != NULL) {
         next = current->next;
+
+        // Free the data using the provided destructor
+        if (destructor != NULL) {
+            for (unsigned int i = 0; i < current->count; i++) {
+                if (current->data[i] != NULL) {
+                    destructor(current->data[i]);
+                }
+            }
+        }
+
         free(current);
         current = next;
     }
-    
+}
+
+void ll_clear(ll_t *list) {
+    if (list == NULL || list->head == NULL) {
+        return;
+    }
+
+    // Keep the head node, it is the one most likely to be filled again
+    ll_node_t *kept = list->head;
+    ll_free_nodes(kept->next, NULL);
+    if (list->spare == NULL) {
+        list->spare = kept;
+    } else {
+        free(kept);
+    }
+
     list->head = NULL;
     list->tail = NULL;
     list->size = 0;
 }
 
+void ll_destroy(ll_t *list) {
+    ll_destroy_nested(list, NULL);
+}
+
 void ll_destroy_nested(ll_t *list, void (*destructor)(void *)) {
     if (list == NULL) {
         return;
     }
-    
-    if (destructor == NULL) {
-        ll_destroy(list);
-        return;
-    }
-    
-    ll_node_t *current = list->head;
-    ll_node_t *next;
-    
-    while (current != NULL) {
-        next = current->next;
-        
-        // Free the data using the provided destructor
-        if (current->data != NULL) {
-            destructor(current->data);
-        }
-        
-        free(current);
-        current = next;
-    }
-    
+
+    ll_free_nodes(list->head, destructor);
+    free(list->spare);
+
     list->head = NULL;
     list->tail = NULL;
     list->size = 0;
+    list->spare = NULL;
 }
 
-bool ll_append(ll_t *list, void *data) {
-    if (list == NULL) {
-        return false;
+// Node with room for one more element at the tail, NULL on allocation failure
+static ll_node_t *ll_tail_room(ll_t *list) {
+    ll_node_t *tail = list->tail;
+    if (tail != NULL && tail->count < LL_CHUNK) {
+        return tail;
     }
-    
-    // Allocate new node
-    ll_node_t *new_node = (ll_node_t *)malloc(sizeof(ll_node_t));
-    if (new_node == NULL) {
-        return false;
+
+    // Allocate new node, or take the spare one
+    ll_node_t *new_node = list->spare;
+    if (new_node != NULL) {
+        list->spare = NULL;
+    } else {
+        new_node = (ll_node_t *)malloc(sizeof(ll_node_t));
+        if (new_node == NULL) {
+            return NULL;
+        }
     }
-    
-    new_node->data = data;
     new_node->next = NULL;
-    
+    new_node->count = 0;
+
     // If list is empty, set both head and tail to new node
-    if (list->head == NULL) {
+    if (tail == NULL) {
         list->head = new_node;
-        list->tail = new_node;
     } else {
-        // Append to tail - O(1) operation
-        list->tail->next = new_node;
-        list->tail = new_node;
+        tail->next = new_node;
+    }
+    list->tail = new_node;
+    return new_node;
+}
+
+bool ll_append(ll_t *list, void *data) {
+    if (list == NULL) {
+        return false;
     }
-    
+
+    // Append to tail - O(1) operation
+    ll_node_t *tail = ll_tail_room(list);
+    if (tail == NULL) {
+        return false;
+    }
+    tail->data[tail->count++] = data;
+
     list->size++;
     return true;
 }
@@ -96,160 +124,107 @@ bool ll_append_safe(ll_t *list, void *data) {
     if (list == NULL) {
         return false;
     }
-    
+
     // Acquire lock before modifying the list
-    lock_acquire(&list->lock);
-    
-    // Allocate new node
-    ll_node_t *new_node = (ll_node_t *)malloc(sizeof(ll_node_t));
-    if (new_node == NULL) {
-        lock_release(&list->lock);
-        return false;
-    }
-    
-    new_node->data = data;
-    new_node->next = NULL;
-    
-    // If list is empty, set both head and tail to new node
-    if (list->head == NULL) {
-        list->head = new_node;
-        list->tail = new_node;
-    } else {
-        // Append to tail - O(1) operation
-        list->tail->next = new_node;
-        list->tail = new_node;
-    }
-    
-    list->size++;
-    
+    park_lock_acquire(&list->lock);
+    bool appended = ll_append(list, data);
     // Release lock after modification is complete
-    lock_release(&list->lock);
-    
-    return true;
+    park_lock_release(&list->lock);
+
+    return appended;
 }
 
 bool ll_concat_safe(ll_t *list1, ll_t *list2) {
     if (list1 == NULL || list2 == NULL) {
         return false;
     }
-    
+
     // Avoid self-concatenation
     if (list1 == list2) {
         return false;
     }
-    
-    lock_acquire(&list1->lock);
-    
+
+    park_lock_acquire(&list1->lock);
+
     // If list2 is empty, nothing to do
     if (list2->head == NULL) {
-        lock_release(&list1->lock);
+        park_lock_release(&list1->lock);
         return true;
     }
-    
+
     // If list1 is empty, just transfer everything from list2
     if (list1->head == NULL) {
         list1->head = list2->head;
         list1->tail = list2->tail;
         list1->size = list2->size;
     } else {
-        // Connect list1's tail to list2's head
+        // Connect list1's tail to list2's head, the partly filled tail node stays in the middle
         list1->tail->next = list2->head;
         list1->tail = list2->tail;
         list1->size += list2->size;
     }
-    
+
     // Clear list2
     list2->head = NULL;
     list2->tail = NULL;
     list2->size = 0;
-    
-    lock_release(&list1->lock);
-    
+
+    park_lock_release(&list1->lock);
+
     return true;
 }
 
-bool ll_remove(ll_t *list, void *data) {
-    if (list == NULL || list->head == NULL) {
-        return false;
-    }
-    
+// Remove the first element matching data, with compare (0 if equal) or by pointer equality
+static bool ll_remove_first(ll_t *list, void *data, int (*compare)(void *, void *)) {
     ll_node_t *current = list->head;
     ll_node_t *prev = NULL;
-    
+
     while (current != NULL) {
-        // Compare pointers
-        if (current->data == data) {
-            // Found the node to remove
+        for (unsigned int i = 0; i < current->count; i++) {
+            if (compare == NULL ? current->data[i] != data : compare(current->data[i], data) != 0) {
+                continue;
+            }
+
+            // Found the element, close the gap to keep the order
+            current->count--;
+            memmove(&current->data[i], &current->data[i + 1], (current->count - i) * sizeof(void *));
+            list->size--;
+            if (current->count > 0) {
+                return true;
+            }
+
+            // The node is empty, unlink it
             if (prev == NULL) {
-                // Removing head
                 list->head = current->next;
-                
-                // If we removed the only node, update tail
-                if (list->head == NULL) {
-                    list->tail = NULL;
-                }
             } else {
-                // Removing middle or tail node
                 prev->next = current->next;
-                
-                // If we removed the tail, update tail pointer
-                if (current == list->tail) {
-                    list->tail = prev;
-                }
             }
-            
+            if (current == list->tail) {
+                list->tail = prev;
+            }
             free(current);
-            list->size--;
             return true;
         }
-        
+
         prev = current;
         current = current->next;
     }
-    
+
     return false;
 }
 
+bool ll_remove(ll_t *list, void *data) {
+    if (list == NULL || list->head == NULL) {
+        return false;
+    }
+    return ll_remove_first(list, data, NULL);
+}
+
 bool ll_remove_cmp(ll_t *list, void *data, int (*compare)(void *, void *)) {
     if (list == NULL || list->head == NULL || compare == NULL) {
         return false;
     }
-    
-    ll_node_t *current = list->head;
-    ll_node_t *prev = NULL;
-    
-    while (current != NULL) {
-        // Use custom comparator
-        if (compare(current->data, data) == 0) {
-            // Found the node to remove
-            if (prev == NULL) {
-                // Removing head
-                list->head = current->next;
-                
-                // If we removed the only node, update tail
-                if (list->head == NULL) {
-                    list->tail = NULL;
-                }
-            } else {
-                // Removing middle or tail node
-                prev->next = current->next;
-                
-                // If we removed the tail, update tail pointer
-                if (current == list->tail) {
-                    list->tail = prev;
-                }
-            }
-            
-            free(current);
-            list->size--;
-            return true;
-        }
-        
-        prev = current;
-        current = current->next;
-    }
-    
-    return false;
+    return ll_remove_first(list, data, compare);
 }
 
 size_t ll_size(ll_t *list) {
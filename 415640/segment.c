@@ -0,0 +1,170 @@
+// Requested features
+#define _POSIX_C_SOURCE   200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <segment.h>
+#include <utils.h>
+
+segment_registry* segments_create(void){
+    segment_registry* segments = aligned_alloc(_Alignof(segment_registry), sizeof(segment_registry));
+    if (unlikely(segments == NULL)){
+        return NULL;
+    }
+    memset(segments, 0, sizeof(segment_registry));
+    return segments;
+}
+
+static void segments_release_limbo(segment_t* segment){
+    while (segment != NULL){
+        segment_t* next = segment->retired;
+        segment_release(segment);
+        segment = next;
+    }
+}
+
+// frees every segment still registered or waiting in limbo, no transaction may be running
+void segments_destroy(segment_registry* segments){
+    if (segments == NULL){
+        return;
+    }
+    for (int i = 0; i < SEGMENT_SHARDS; i++){
+        for (segment_t* segment = segments->shards[i].head; segment != NULL;){
+            segment_t* next = segment->next;
+            segment_release(segment);
+            segment = next;
+        }
+    }
+    for (int i = 0; i < 3; i++){
+        segments_release_limbo(atomic_load(&segments->limbo[i]));
+    }
+    free(segments);
+}
+
+// bytes before the data, a multiple of the allocation alignment
+static inline size_t segment_header_size(size_t align){
+    return (sizeof(segment_t) + align - 1) & ~(align - 1);
+}
+
+static inline size_t segment_align(shared_rgn* region){
+    return region->align < sizeof(void*) ? sizeof(void*) : region->align;
+}
+
+// zeroed data of a new segment, not registered yet, NULL if out of memory
+void* segment_alloc(shared_rgn* region, size_t size){
+    size_t align = segment_align(region);
+    size_t header = segment_header_size(align);
+    void* base;
+    if (unlikely(posix_memalign(&base, align, header + size) != 0)){
+        return NULL;
+    }
+    segment_t* segment = (segment_t*)((char*)base + header - sizeof(segment_t));
+    segment->prev = NULL;
+    segment->next = NULL;
+    segment->retired = NULL;
+    segment->region = region;
+    segment->size = size;
+    segment->shard = 0;
+    void* data = (char*)base + header;
+    memset(data, 0, size);
+    return data;
+}
+
+// segment starting at data, NULL if it is the first segment or one of another region
+segment_t* segment_of(shared_rgn* region, void* data){
+    if (unlikely(data == NULL || data == region->start || (uintptr_t)data % segment_align(region) != 0)){
+        return NULL;
+    }
+    segment_t* segment = (segment_t*)data - 1;
+    return segment->region == region ? segment : NULL;
+}
+
+void segment_release(segment_t* segment){
+    size_t align = segment_align(segment->region);
+    free((char*)(segment + 1) - segment_header_size(align));
+}
+
+// link a committed chain of segments (first to last by 'next') into the caller's shard
+void segments_publish(segment_registry* segments, segment_t* first, segment_t* last){
+    unsigned int index = thread_slot() % SEGMENT_SHARDS;
+    segment_shard* shard = &segments->shards[index];
+    for (segment_t* segment = first; segment != last->next; segment = segment->next){
+        segment->shard = index;
+    }
+
+    park_lock_acquire(&shard->lock);
+    last->next = shard->head;
+    if (shard->head != NULL){
+        shard->head->prev = last;
+    }
+    first->prev = NULL;
+    shard->head = first;
+    park_lock_release(&shard->lock);
+}
+
+// unlink a committed segment from its shard in O(1)
+void segments_remove(segment_registry* segments, segment_t* segment){
+    segment_shard* shard = &segments->shards[segment->shard];
+
+    park_lock_acquire(&shard->lock);
+    if (segment->prev != NULL){
+        segment->prev->next = segment->next;
+    } else {
+        shard->head = segment->next;
+    }
+    if (segment->next != NULL){
+        segment->next->prev = segment->prev;
+    }
+    park_lock_release(&shard->lock);
+}
+
+// hand an unlinked segment to reclamation, epoch being the one of the freeing transaction
+void segments_retire(segment_registry* segments, segment_t* segment, uint64_t epoch){
+    _Atomic(segment_t*)* limbo = &segments->limbo[epoch % 3];
+    segment_t* head = atomic_load_explicit(limbo, memory_order_relaxed);
+    do {
+        segment->retired = head;
+    } while (!atomic_compare_exchange_weak_explicit(limbo, &head, segment, memory_order_release, memory_order_relaxed));
+}
+
+// register a beginning transaction in the current epoch, returned with the counter shard to exit from
+uint64_t epoch_enter(segment_registry* segments, unsigned int* shard){
+    *shard = thread_slot() % EPOCH_SHARDS;
+    _Atomic long* active = segments->epochs[*shard].active;
+    for (;;){
+        uint64_t epoch = atomic_load(&segments->epoch);
+        atomic_fetch_add(&active[epoch % 3], 1);
+        // an advance checking the counters before the increment is seen here
+        if (likely(atomic_load(&segments->epoch) == epoch)){
+            return epoch;
+        }
+        atomic_fetch_sub(&active[epoch % 3], 1);
+    }
+}
+
+void epoch_exit(segment_registry* segments, unsigned int shard, uint64_t epoch){
+    atomic_fetch_sub_explicit(&segments->epochs[shard].active[epoch % 3], 1, memory_order_release);
+}
+
+// Move from epoch e to e + 1 once no transaction of epoch e - 1 runs anymore, and release the
+// segments freed in epoch e - 2: every transaction that could still see them has ended.
+// Returns whether the epoch moved.
+bool epoch_try_advance(segment_registry* segments){
+    if (!lock_try_acquire(&segments->advancing)){
+        return false; // another thread is on it
+    }
+    uint64_t epoch = atomic_load(&segments->epoch);
+    for (int i = 0; i < EPOCH_SHARDS; i++){
+        if (atomic_load(&segments->epochs[i].active[(epoch + 2) % 3]) != 0){
+            lock_release(&segments->advancing);
+            return false;
+        }
+    }
+    // freed in epoch - 2, the next one to reuse this list is epoch + 1
+    segment_t* released = atomic_exchange(&segments->limbo[(epoch + 1) % 3], NULL);
+    atomic_store(&segments->epoch, epoch + 1);
+    lock_release(&segments->advancing);
+
+    segments_release_limbo(released);
+    return true;
+}
@@ -0,0 +1,48 @@
+// Requested features
+#define _POSIX_C_SOURCE   200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <stats.h>
+#include <utils.h>
+
+stats_shard* stats_create(void){
+    stats_shard* shards = aligned_alloc(_Alignof(stats_shard), sizeof(stats_shard) * STATS_SHARDS);
+    if (unlikely(shards == NULL)){
+        return NULL;
+    }
+    memset(shards, 0, sizeof(stats_shard) * STATS_SHARDS);
+    return shards;
+}
+
+void stats_destroy(stats_shard* shards){
+    free(shards);
+}
+
+// shard of the calling thread, threads beyond STATS_SHARDS share shards
+stats_shard* stats_local(stats_shard* shards){
+    return &shards[thread_slot() % STATS_SHARDS];
+}
+
+#define stats_load(counter) atomic_load_explicit(&(counter), memory_order_relaxed)
+
+void stats_sum(stats_shard* shards, tm_stats_t* out){
+    memset(out, 0, sizeof(*out));
+    for (int i = 0; i < STATS_SHARDS; i++){
+        stats_shard* shard = &shards[i];
+        out->commits_ro += stats_load(shard->commits_ro);
+        out->commits_rw += stats_load(shard->commits_rw);
+        out->aborts_ro += stats_load(shard->aborts_ro);
+        out->aborts_rw += stats_load(shard->aborts_rw);
+        for (int c = 0; c < TM_ABORT_CAUSES; c++){
+            out->aborts_by_cause[c] += stats_load(shard->aborts_by_cause[c]);
+        }
+        for (int b = 0; b < TM_STATS_SIZE_BUCKETS; b++){
+            out->read_set_sizes[b] += stats_load(shard->read_set_sizes[b]);
+            out->write_set_sizes[b] += stats_load(shard->write_set_sizes[b]);
+        }
+        out->allocs += stats_load(shard->allocs);
+        out->frees += stats_load(shard->frees);
+        out->commit_ns += stats_load(shard->commit_ns);
+    }
+}
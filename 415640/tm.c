@@ -22,25 +22,79 @@
 
 // External headers
 #include "stdio.h"
+#include <sys/mman.h>       // (madvise)
 // Internal headers
 #include <tm.h>
-#include <utils.h>          // nested free, add/rm_from_dict, get_lock_pointer
+#include <tm_ext.h>         // tm_create_ex and its options
+#include <utils.h>          // dictionary callbacks, get_lock_pointer
 #include <tx_t.h>           // transaction struct
 #include <string.h>         // (memset)
 #include <shared_t.h>       // shared memory region
 #include <version_types.h>  // global and lock versioning
 #include <dict.h>           // alloc/free-set
-#include <ll.h>             // segment and read/write set
+#include <ll.h>             // free set
+#include <segment.h>        // segment registry and reclamation
+#include <stats.h>          // per-region statistics
+#include <trace.h>          // per-region event tracing
 #include "macros.h"
 #include "params.h"
 
 
+/** Fill the given options with the values used by 'tm_create'.
+ * @param options Options to initialize
+**/
+void tm_options_default(tm_options_t* options) {
+    options->lock_count = LOCK_ARRAY_SIZE;
+    options->lock_granularity = LOCK_GRANULARITY;
+    options->lock_mapping = TM_LOCK_MAP_HASHED;
+    options->engine = TM_ENGINE_TL2;
+    options->backoff = TM_BACKOFF_NONE;
+    options->huge_pages = false;
+    options->stats = false;
+    options->trace_path = NULL;
+    options->trace_signal = 0;
+}
+
+static void word_access_select(shared_rgn* shared_region);
+
+// allocate size bytes aligned on align, backed by transparent huge pages when asked and worth it
+static void* region_memalign(size_t align, size_t size, bool huge_pages) {
+    void* mem;
+    huge_pages = huge_pages && size >= HUGE_PAGE_SIZE;
+    if (huge_pages && align < HUGE_PAGE_SIZE){
+        align = HUGE_PAGE_SIZE;
+    }
+    if (unlikely(posix_memalign(&mem, align, size) != 0)){
+        return NULL;
+    }
+    if (huge_pages){
+        madvise(mem, size, MADV_HUGEPAGE); // only a hint, failure is harmless
+    }
+    return mem;
+}
+
 /** Create (i.e. allocate + init) a new shared memory region, with one first non-free-able allocated segment of the requested size and alignment.
  * @param size  Size of the first shared segment of memory to allocate (in bytes), must be a positive multiple of the alignment
  * @param align Alignment (in bytes, must be a power of 2) that the shared memory region must support
  * @return Opaque shared memory region handle, 'invalid_shared' on failure
 **/
 shared_t tm_create(size_t size, size_t align) {
+    return tm_create_ex(size, align, NULL);
+}
+
+/** Create (i.e. allocate + init) a new shared memory region, tuned by the given options.
+ * @param size    Size of the first shared segment of memory to allocate (in bytes), must be a positive multiple of the alignment
+ * @param align   Alignment (in bytes, must be a power of 2) that the shared memory region must support
+ * @param options Tuning options, NULL for the defaults of 'tm_create'
+ * @return Opaque shared memory region handle, 'invalid_shared' on failure (including invalid options)
+**/
+shared_t tm_create_ex(size_t size, size_t align, tm_options_t const* options) {
+    tm_options_t opts;
+    if (options == NULL){
+        tm_options_default(&opts);
+    } else {
+        opts = *options;
+    }
 
     if (unlikely(!((align > 0) && !(align & (align - 1))))){
         return invalid_shared;
@@ -48,20 +102,24 @@ shared_t tm_create(size_t size, size_t align) {
     if (size % align != 0 || (size >> 48) > 0){
         return invalid_shared;
     }
-
-
-    // make linked list for segments
-    ll_t* segments = malloc(sizeof(ll_t));
-    if(unlikely(!ll_init(segments))){
+    if (unlikely(opts.lock_count == 0 || (opts.lock_count & (opts.lock_count - 1)))){
+        return invalid_shared;
+    }
+    if (unlikely(opts.lock_granularity == 0 || (opts.lock_granularity & (opts.lock_granularity - 1)))){
+        return invalid_shared;
+    }
+    if (unlikely(opts.lock_mapping > TM_LOCK_MAP_STRIPED)){
+        return invalid_shared;
+    }
+    if (unlikely(opts.engine != TM_ENGINE_TL2 || opts.backoff > TM_BACKOFF_EXPONENTIAL)){
         return invalid_shared;
     }
 
+
     // creation of segment
-    void* first_segment;
-    int res_mem_align = posix_memalign(&first_segment, align, size);
+    void* first_segment = region_memalign(align, size, opts.huge_pages);
 
-    if (unlikely(res_mem_align != 0)){
-        free(segments);
+    if (unlikely(first_segment == NULL)){
         return invalid_shared;
     }
     memset(first_segment, 0, size);
@@ -69,30 +127,65 @@ shared_t tm_create(size_t size, size_t align) {
     shared_rgn* shared_region = malloc(sizeof(shared_rgn));
     if (unlikely(shared_region == NULL)){
         free(first_segment);
-        free(segments);
         return invalid_shared;
     }
     
 
-    version_lock* locks = malloc(sizeof(version_lock)*LOCK_ARRAY_SIZE);
+    size_t locks_size = sizeof(version_lock)*opts.lock_count;
+    version_lock* locks = region_memalign(sizeof(void*), locks_size, opts.huge_pages);
     if (unlikely(locks == NULL)){
         free(shared_region);
         free(first_segment);
-        free(segments);
         return invalid_shared;
     }
     // initialize locks to 0
-    memset(locks, 0, sizeof(version_lock)*LOCK_ARRAY_SIZE);
-    ll_append(segments, first_segment);
+    memset(locks, 0, locks_size);
+
+    // registry of the segments allocated by transactions
+    segment_registry* segments = segments_create();
+    if (unlikely(segments == NULL)){
+        free(locks);
+        free(shared_region);
+        free(first_segment);
+        return invalid_shared;
+    }
 
 
     shared_region->global_version = 0;
     shared_region->start = first_segment;
     shared_region->size = size;
     shared_region->align = align;
+    word_access_select(shared_region);
 
     shared_region->segments = segments;
+
     shared_region->locks = locks;
+    shared_region->lock_mask = opts.lock_count - 1;
+    shared_region->lock_shift = __builtin_ctzl(opts.lock_granularity);
+    shared_region->lock_striped = opts.lock_mapping == TM_LOCK_MAP_STRIPED;
+    shared_region->lock_range_check = lock_check_range_select();
+    shared_region->options = opts;
+    shared_region->options.trace_path = NULL;
+    shared_region->stats = NULL;
+    shared_region->trace = NULL;
+#if TM_STATS
+    if (opts.stats){
+        shared_region->stats = stats_create();
+        if (unlikely(shared_region->stats == NULL)){
+            tm_destroy(shared_region);
+            return invalid_shared;
+        }
+    }
+#endif
+    if (opts.trace_path != NULL){
+        // keep our own copy, the caller's string may not outlive the region
+        shared_region->options.trace_path = strdup(opts.trace_path);
+        shared_region->trace = trace_create(opts.trace_signal);
+        if (unlikely(shared_region->options.trace_path == NULL || shared_region->trace == NULL)){
+            tm_destroy(shared_region);
+            return invalid_shared;
+        }
+    }
     
     return shared_region;
 }
@@ -103,9 +196,17 @@ shared_t tm_create(size_t size, size_t align) {
 void tm_destroy(shared_t shared) {
     shared_rgn* shared_region = (shared_rgn*)shared;
 
+    if (shared_region->trace != NULL){
+        trace_dump(shared_region->trace, shared_region, shared_region->options.trace_path);
+        trace_destroy(shared_region->trace);
+    }
+    free((char*)shared_region->options.trace_path);
+
     // free each segment + each lock array + destroy dict itself
-    ll_destroy_nested(shared_region->segments, free);
+    segments_destroy(shared_region->segments);
+    free(shared_region->start);
     free(shared_region->locks);
+    stats_destroy(shared_region->stats);
     free(shared_region);
 
     return;
@@ -135,6 +236,51 @@ size_t tm_align(shared_t shared) {
     return ((shared_rgn*)shared)->align;
 }
 
+/** [thread-safe] Read the statistics of a region created with the 'stats' option.
+ * @param shared Shared memory region to query
+ * @param out    Statistics to fill
+ * @return Whether statistics are available (collected and not compiled out)
+**/
+bool tm_stats(shared_t shared, tm_stats_t* out) {
+    shared_rgn* shared_region = (shared_rgn*)shared;
+
+    if (shared_region->stats == NULL){
+        return false;
+    }
+    stats_sum(shared_region->stats, out);
+    return true;
+}
+
+/** [thread-safe] Write the events recorded so far by a region created with a 'trace_path'.
+ * @param shared Shared memory region to dump
+ * @param path   File to write
+ * @return Whether tracing is enabled and the file was written
+**/
+bool tm_trace_dump(shared_t shared, char const* path) {
+    shared_rgn* shared_region = (shared_rgn*)shared;
+
+    if (shared_region->trace == NULL){
+        return false;
+    }
+    return trace_dump(shared_region->trace, shared_region, path);
+}
+
+static const trace_event_type abort_trace_events[TM_ABORT_CAUSES] = {
+    [TM_ABORT_READ_LOCKED] = TRACE_READ_ABORT,
+    [TM_ABORT_READ_STALE] = TRACE_READ_ABORT,
+    [TM_ABORT_LOCK_ACQUIRE] = TRACE_LOCK_FAIL,
+    [TM_ABORT_VALIDATION] = TRACE_VALIDATE_FAIL,
+    [TM_ABORT_OTHER] = TRACE_ABORT,
+};
+
+// abort and destroy the transaction, recording why (and on which lock, if any)
+static void tx_abort(shared_rgn* shared_region, transaction_t* transaction, tm_abort_cause_t cause, version_lock* lock, uint64_t start) {
+    trace_record(shared_region, abort_trace_events[cause], (uintptr_t)transaction, lock, lock == NULL ? 0 : atomic_load(lock));
+    stats_end(shared_region, transaction, false, cause, start);
+    epoch_exit(shared_region->segments, transaction->epoch_shard, transaction->epoch);
+    tx_retire(transaction, false);
+}
+
 /** [thread-safe] Begin a new transaction on the given shared memory region.
  * @param shared Shared memory region to start a transaction on
  * @param is_ro  Whether the transaction is read-only
@@ -143,23 +289,52 @@ size_t tm_align(shared_t shared) {
 tx_t tm_begin(shared_t shared, bool is_ro) {
     shared_rgn* shared_region = (shared_rgn*)shared;
 
-    transaction_t* tx = malloc(sizeof(transaction_t));
-    if (unlikely(tx == NULL)){
-        return invalid_tx;
+    // descriptors of ended transactions come back with their sets already sized
+    transaction_t* tx = tx_reuse(NULL);
+    if (tx == NULL){
+        tx = tx_create();
+        if (unlikely(tx == NULL)){
+            return invalid_tx;
+        }
     }
 
+    tx->epoch = epoch_enter(shared_region->segments, &tx->epoch_shard);
     tx->read_version = atomic_load(&shared_region->global_version);
     tx->write_version = 0;
 
     tx->read_only = is_ro;
-    tx->read_set = dic_new(0);
-    tx->write_set = dic_new(0);
-    tx->alloc_set = malloc(sizeof(struct ll));
-    ll_init(tx->alloc_set);
+
+    trace_record(shared_region, TRACE_BEGIN, (uintptr_t)tx, NULL, tx->read_version);
 
     return (tx_t)tx;
 }
 
+/** [thread-safe] Restart an ended transaction in place with a fresh snapshot.
+ * @param shared Shared memory region associated with the transaction
+ * @param tx     Transaction that ended on the calling thread
+ * @param is_ro  Whether the restarted transaction is read-only
+ * @return Whether the transaction restarted, false if its descriptor is no longer kept
+**/
+bool tm_restart(shared_t shared, tx_t tx, bool is_ro) {
+    shared_rgn* shared_region = (shared_rgn*)shared;
+
+    transaction_t* transaction = tx_reuse((transaction_t*)tx);
+    if (unlikely(transaction == NULL)){
+        return false;
+    }
+
+    transaction->epoch = epoch_enter(shared_region->segments, &transaction->epoch_shard);
+    transaction->read_version = atomic_load(&shared_region->global_version);
+    transaction->write_version = 0;
+
+    // the descriptor may have been reused by a transaction of the other mode since tx ended
+    transaction->read_only = is_ro;
+
+    trace_record(shared_region, TRACE_BEGIN, tx, NULL, transaction->read_version);
+
+    return true;
+}
+
 /** [thread-safe] End the given transaction.
  * @param shared Shared memory region associated with the transaction
  * @param tx     Transaction to end
@@ -170,37 +345,35 @@ bool tm_end(shared_t shared, tx_t tx) {
     transaction_t* transaction = (transaction_t*)tx;
 
     if(transaction->read_only){
-        tx_destroy(transaction, true);
+        trace_record(shared_region, TRACE_COMMIT, tx, NULL, transaction->read_version);
+        stats_end(shared_region, transaction, true, TM_ABORT_OTHER, 0);
+        epoch_exit(shared_region->segments, transaction->epoch_shard, transaction->epoch);
+        tx_retire(transaction, true);
         return true;
     }
+    uint64_t start = stats_clock(shared_region);
 
     // creation of support struct
-    region_and_index* ri = malloc(sizeof(region_and_index));
-    if (unlikely(ri == NULL)){
-        tx_destroy(transaction, false);
-        return false;
-    }
-    ri->region = shared_region;
-    ri->transaction = transaction;
-    ri->key = NULL;
+    region_and_index support = { shared_region, transaction, NULL };
+    region_and_index* ri = &support;
 
     // lock the write set 
 
-    // create a dict with only only unique locks
-    struct dictionary* unique_locks = dic_new(0);
+    // fill the (reused) dict with only unique locks
+    struct dictionary* unique_locks = transaction->unique_locks;
     ri->key = unique_locks;
     dic_forEach(transaction->write_set, unique_lock_create, ri);
 
     ri->key = NULL;
-    dic_forEach(unique_locks, lock_unique_lock_set, ri);
+    transaction->lock_tag = lock_owner_tag(thread_slot());
+    dic_forEachAhead(unique_locks, lock_unique_lock_set, prefetch_unique_lock, COMMIT_PREFETCH_DISTANCE, ri);
 
     // rollback in case locks were already acquired
     if(ri->key != NULL){
         //printf("TM_END: TRANSACTION FAILED, failed to acquire all locks write set\n");fflush(stdout);
+        version_lock* busy_lock = ri->key;
         dic_forEach(unique_locks, unlock_unique_lock_set_until, ri);
-        dic_delete(unique_locks);
-        free(ri);
-        tx_destroy(transaction, false);
+        tx_abort(shared_region, transaction, TM_ABORT_LOCK_ACQUIRE, busy_lock, start);
         return false;
     }
     // fetch and increment global counter    
@@ -210,78 +383,209 @@ bool tm_end(shared_t shared, tx_t tx) {
         //printf("TM_END: validating writing set: rv:%d, wv:%d\n", transaction->read_version, transaction->write_version);fflush(stdout);
         
         // validating reading set
-        ri->key = transaction->write_set; // supply write_set to only check version of already locked words
-        dic_forEach(transaction->read_set, validate_reading_set, ri);
+        dic_forEachAhead(transaction->read_set, validate_reading_set, prefetch_reading_lock, COMMIT_PREFETCH_DISTANCE, ri);
+        version_lock* invalid_lock = ri->key; // set to the failing lock by validate_reading_set
         ri->key = NULL;
 
         if(ri->transaction == NULL){
             //printf("TM_END: TRANSACTION FAILED, failed to validate reading set\n");fflush(stdout);
             dic_forEach(unique_locks, unlock_unique_lock_set_until, ri);
-            dic_delete(unique_locks);
-            free(ri);
-            tx_destroy(transaction, false);
+            tx_abort(shared_region, transaction, TM_ABORT_VALIDATION, invalid_lock, start);
             return false;
         }
     }
 
-    dic_forEach(transaction->write_set, write_writing_set, ri);         // write values 
-    dic_forEach(unique_locks, update_unique_lock_set, ri);  // and releases all held locks
+    // publish the new segments while the written words are still locked: a transaction can only
+    // free a segment once it read its address, so its unlink never runs before the link
+    segment_registry* segments = shared_region->segments;
+    if (transaction->allocs != NULL){
+        segments_publish(segments, transaction->allocs, transaction->allocs_last);
+    }
+
+    dic_forEachAhead(transaction->write_set, write_writing_set, prefetch_writing_word, COMMIT_PREFETCH_DISTANCE, ri); // write values
+    dic_forEachAhead(unique_locks, update_unique_lock_set, prefetch_unique_lock, COMMIT_PREFETCH_DISTANCE, ri); // and releases all held locks
 
-    ll_concat_safe(shared_region->segments, transaction->alloc_set);
-    
-    dic_delete(unique_locks);
-    free(ri);
-    tx_destroy(transaction, true);
+    bool freed = !ll_is_empty(transaction->free_set);
+    for (ll_node_t* node = transaction->free_set->head; node != NULL; node = node->next){
+        for (unsigned int i = 0; i < node->count; i++){
+            segments_remove(segments, node->data[i]);
+            segments_retire(segments, node->data[i], transaction->epoch);
+        }
+    }
+
+    trace_record(shared_region, TRACE_COMMIT, tx, NULL, transaction->write_version);
+    stats_end(shared_region, transaction, true, TM_ABORT_OTHER, start);
+    epoch_exit(segments, transaction->epoch_shard, transaction->epoch);
+    tx_retire(transaction, true);
+    // up to three advances, one per epoch, so limbo drains down to this commit's own frees
+    for (int i = 0; freed && i < 3; i++){
+        if (!epoch_try_advance(segments)){
+            break;
+        }
+    }
     return true;
 }
 
-/** [thread-safe] Read operation in the given transaction, source in the shared region and target in a private region.
- * @param shared Shared memory region associated with the transaction
- * @param tx     Transaction to use
- * @param source Source start address (in the shared region)
- * @param size   Length to copy (in bytes), must be a positive multiple of the alignment
- * @param target Target start address (in a private region)
- * @return Whether the whole transaction can continue
-**/
-bool tm_read(shared_t shared, tx_t tx, void const* source, size_t size, void* target) {
-    shared_rgn* shared_region = (shared_rgn*)shared;
-    transaction_t* transaction = (transaction_t*)tx;
+// why a read failed its lock check
+static inline tm_abort_cause_t read_abort_cause(version_lock* lock) {
+    return atomic_load(lock) & 0x1 ? TM_ABORT_READ_LOCKED : TM_ABORT_READ_STALE;
+}
+
+// bulk check of the consecutive locks covering [source, source + size), NULL if all pass
+static version_lock* striped_check(shared_rgn* shared_region, void const* source, size_t size, int read_version) {
+    size_t lock_count = shared_region->lock_mask + 1;
+    uintptr_t first = (uintptr_t)source >> shared_region->lock_shift;
+    uintptr_t last = ((uintptr_t)source + size - 1) >> shared_region->lock_shift;
+    size_t count = last - first + 1;
+    size_t begin = first & shared_region->lock_mask;
+    if (count > lock_count){
+        begin = 0;
+        count = lock_count;
+    }
 
+    // the range may wrap around the end of the lock table
+    size_t head = count < lock_count - begin ? count : lock_count - begin;
+    version_lock* failed = shared_region->lock_range_check(&shared_region->locks[begin], head, read_version);
+    if (failed == NULL && head < count){
+        failed = shared_region->lock_range_check(shared_region->locks, count - head, read_version);
+    }
+    return failed;
+}
+
+// multi-word read with a striped lock mapping: check all covering locks, copy, check again
+static bool tm_read_striped(shared_rgn* shared_region, transaction_t* transaction, void const* source, size_t size, void* target) {
     size_t word_size = shared_region->align;
 
-    for(size_t i = 0; i < size/word_size; i ++){
-        void* current_source_word = (void*)source+i*word_size;
-        void* current_target_word = target+i*word_size;
-        version_lock* current_version_lock = lock_get_from_pointer((shared_rgn*)shared, current_source_word);
+    version_lock* failed = striped_check(shared_region, source, size, transaction->read_version);
+    if(failed == NULL){
+        memcpy(target, source, size);
+        failed = striped_check(shared_region, source, size, transaction->read_version);
+    }
+    if(failed != NULL){
+        tx_abort(shared_region, transaction, read_abort_cause(failed), failed, 0);
+        return false;
+    }
+
+    if(!transaction->read_only){
+        for(size_t i = 0; i < size; i += word_size){
+            void* current_source_word = (void*)source + i;
+            dic_add(transaction->read_set, current_source_word, 8);
+            if(dic_find(transaction->write_set, current_source_word, 8)){
+                memcpy(target + i, *transaction->write_set->value, word_size);
+            }
+        }
+    }
+    return true;
+}
+
+// Word-by-word bodies of tm_read and tm_write. They are instantiated below with a constant
+// word size for the common alignments, so that the copies become plain loads and stores and
+// the loop bounds need no division.
+
+static force_inline bool read_words(shared_rgn* shared_region, transaction_t* transaction, void const* source, size_t size, void* target, size_t word_size){
+    for(size_t i = 0; i < size; i += word_size){
+        void* current_source_word = (void*)source + i;
+        void* current_target_word = target + i;
+        version_lock* current_version_lock = lock_get_from_pointer(shared_region, current_source_word);
 
         if(!lock_check(current_version_lock, transaction->read_version)){
-            //printf("TM_READ: first check for lock failed: %p has val %d when rv:%d\n", current_version_lock, *current_version_lock, transaction->read_version);fflush(stdout);
-            tx_destroy(transaction, false);
+            tx_abort(shared_region, transaction, read_abort_cause(current_version_lock), current_version_lock, 0);
             return false;
         }
 
         if(!transaction->read_only){
             dic_add(transaction->read_set, current_source_word, 8);
-            ////printf("TM_READ: adding to read-set: %p\n", current_source_word);fflush(stdout);
             if(dic_find(transaction->write_set, current_source_word, 8)){
-                ////printf("TM_READ: reading from write-set: %p\n", current_source_word);fflush(stdout);
                 current_source_word = *transaction->write_set->value;
             }
         }
 
+        // copy between the two checks, a commit overwriting the word in the meantime fails the second one
+        memcpy(current_target_word, current_source_word, word_size);
+
         if(!lock_check(current_version_lock, transaction->read_version)){
-            //printf("TM_READ: second check for lock failed: %p has val %d when rv:%d\n", current_version_lock, *current_version_lock, transaction->read_version);fflush(stdout);
-            tx_destroy(transaction, false);
+            tx_abort(shared_region, transaction, read_abort_cause(current_version_lock), current_version_lock, 0);
             return false;
         }
+    }
 
-        memcpy(current_target_word, current_source_word, word_size);
+    return true;
+}
+
+static force_inline bool write_words(shared_rgn* shared_region, transaction_t* transaction, void const* source, size_t size, void* target, size_t word_size){
+    if(unlikely(size % word_size != 0)){
+        tx_abort(shared_region, transaction, TM_ABORT_OTHER, NULL, 0);
+        return false;
+    }
 
+    for(size_t i = 0; i < size; i += word_size){
+        // a word written again in the same transaction reuses its copy
+        int added = dic_add(transaction->write_set, target + i, 8);
+        if(added == 0){
+            *transaction->write_set->value = dic_alloc(transaction->write_set, word_size);
+        }
+        if(unlikely(added < 0 || *transaction->write_set->value == NULL)){
+            tx_abort(shared_region, transaction, TM_ABORT_OTHER, NULL, 0);
+            return false;
+        }
+        memcpy(*transaction->write_set->value, source + i, word_size); // entries are always going to be of size align
     }
 
     return true;
 }
 
+#define WORD_ACCESS(bytes) \
+    static bool read_words_##bytes(shared_rgn* shared_region, transaction_t* transaction, void const* source, size_t size, void* target){ \
+        return read_words(shared_region, transaction, source, size, target, bytes); \
+    } \
+    static bool write_words_##bytes(shared_rgn* shared_region, transaction_t* transaction, void const* source, size_t size, void* target){ \
+        return write_words(shared_region, transaction, source, size, target, bytes); \
+    }
+
+WORD_ACCESS(8)
+WORD_ACCESS(16)
+WORD_ACCESS(32)
+WORD_ACCESS(64)
+#undef WORD_ACCESS
+
+static bool read_words_any(shared_rgn* shared_region, transaction_t* transaction, void const* source, size_t size, void* target){
+    return read_words(shared_region, transaction, source, size, target, shared_region->align);
+}
+
+static bool write_words_any(shared_rgn* shared_region, transaction_t* transaction, void const* source, size_t size, void* target){
+    return write_words(shared_region, transaction, source, size, target, shared_region->align);
+}
+
+// pick the word access functions matching the region alignment, once at creation
+static void word_access_select(shared_rgn* shared_region){
+    switch(shared_region->align){
+        case 8:  shared_region->read_words = read_words_8;  shared_region->write_words = write_words_8;  break;
+        case 16: shared_region->read_words = read_words_16; shared_region->write_words = write_words_16; break;
+        case 32: shared_region->read_words = read_words_32; shared_region->write_words = write_words_32; break;
+        case 64: shared_region->read_words = read_words_64; shared_region->write_words = write_words_64; break;
+        default: shared_region->read_words = read_words_any; shared_region->write_words = write_words_any; break;
+    }
+}
+
+/** [thread-safe] Read operation in the given transaction, source in the shared region and target in a private region.
+ * @param shared Shared memory region associated with the transaction
+ * @param tx     Transaction to use
+ * @param source Source start address (in the shared region)
+ * @param size   Length to copy (in bytes), must be a positive multiple of the alignment
+ * @param target Target start address (in a private region)
+ * @return Whether the whole transaction can continue
+**/
+bool tm_read(shared_t shared, tx_t tx, void const* source, size_t size, void* target) {
+    shared_rgn* shared_region = (shared_rgn*)shared;
+    transaction_t* transaction = (transaction_t*)tx;
+
+    if(shared_region->lock_striped && (size >> shared_region->lock_shift) >= LOCK_RANGE_MIN){
+        return tm_read_striped(shared_region, transaction, source, size, target);
+    }
+
+    return shared_region->read_words(shared_region, transaction, source, size, target);
+}
+
 /** [thread-safe] Write operation in the given transaction, source in a private region and target in the shared region.
  * @param shared Shared memory region associated with the transaction
  * @param tx     Transaction to use
@@ -292,27 +596,10 @@ bool tm_read(shared_t shared, tx_t tx, void const* source, size_t size, void* ta
 **/
 bool tm_write(shared_t shared, tx_t tx, void const* source, size_t size, void* target) {
     ////printf("TM_WRITE: SANITY: source: %p, with value: %ld, target:%p with value:%ld\n", source, *(long*)source, target, *(long*)target);fflush(stdout);
-    size_t word_size = tm_align(shared);
+    shared_rgn* shared_region = (shared_rgn*)shared;
     transaction_t* transaction = (transaction_t*)tx;
 
-    if(unlikely(size % word_size != 0)){
-        tx_destroy(transaction, false);
-        return false;
-    }
-    
-    void* starting_target_word = target;
-
-    for(size_t i = 0; i < size; i+=word_size){
-        void* cpy_of_write = malloc(word_size);
-        memcpy(cpy_of_write, source + i, word_size);
-        
-        dic_add(transaction->write_set, starting_target_word + i, 8);
-        *transaction->write_set->value = cpy_of_write; // entries are always going to be of size align
-        //printf("TM_WRITE: adding to write-set: %p with lcok:%p; %zuth value: %ld\n", 
-            //starting_target_word + i, lock_get_from_pointer(shared, starting_target_word + i), i, *(long*)cpy_of_write);fflush(stdout);
-    }
-    
-    return true;
+    return shared_region->write_words(shared_region, transaction, source, size, target);
 }
 
 /** [thread-safe] Memory allocation in the given transaction.
@@ -336,15 +623,22 @@ alloc_t tm_alloc(shared_t shared, tx_t tx, size_t size, void** target) {
         return nomem_alloc;
     }
 
-    // allocate memory eagerly
-    int res_memalign = posix_memalign(target, align, size);
-    if(unlikely(res_memalign != 0 || *target == NULL)){
+    // allocate memory eagerly, zeroed
+    *target = segment_alloc(shared_region, size);
+    if(unlikely(*target == NULL)){
         return nomem_alloc;
     }
-    memset(*target, 0, size);
 
-    // bookeep in transaction
-    ll_append(transaction->alloc_set, *target);
+    // bookeep in transaction, published to the region at commit
+    segment_t* segment = segment_of(shared_region, *target);
+    segment->next = transaction->allocs;
+    if (transaction->allocs != NULL){
+        transaction->allocs->prev = segment;
+    } else {
+        transaction->allocs_last = segment;
+    }
+    transaction->allocs = segment;
+    stats_alloc(shared_region);
 
     return success_alloc;
 }
@@ -352,9 +646,20 @@ alloc_t tm_alloc(shared_t shared, tx_t tx, size_t size, void** target) {
 /** [thread-safe] Memory freeing in the given transaction.
  * @param shared Shared memory region associated with the transaction
  * @param tx     Transaction to use
- * @param target Address of the first byte of the previously allocated segment to deallocate
+ * @param target Address of the first byte of the previously allocated segment to deallocate, exactly as
+ *               returned by 'tm_alloc' (the segment header before it is trusted, other addresses are undefined behavior)
  * @return Whether the whole transaction can continue
 **/
-bool tm_free(shared_t unused(shared), tx_t unused(tx), void* unused(target)) {
+bool tm_free(shared_t shared, tx_t tx, void* target) {
+    shared_rgn* shared_region = (shared_rgn*)shared;
+    transaction_t* transaction = (transaction_t*)tx;
+
+    // unlinked at commit, released once no running transaction can still read it
+    segment_t* segment = segment_of(shared_region, target);
+    if(unlikely(segment == NULL || !ll_append(transaction->free_set, segment))){
+        tx_abort(shared_region, transaction, TM_ABORT_OTHER, NULL, 0);
+        return false;
+    }
+    stats_free(shared_region);
     return true;
 }
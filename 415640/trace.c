@@ -0,0 +1,196 @@
+// Requested features
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE   200809L
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include <trace.h>
+#include <utils.h>
+
+// dump requests raised by the trace signal, shared by every traced region
+static _Atomic unsigned int trace_signal_requests = 0;
+
+// the handler is installed once per signal and the previous action restored with its last region
+static park_lock trace_signal_lock = 0;
+static unsigned int trace_signal_users[NSIG];
+static struct sigaction trace_signal_previous[NSIG];
+
+static const char* const trace_event_names[] = {
+    [TRACE_BEGIN] = "begin",
+    [TRACE_READ_ABORT] = "read-abort",
+    [TRACE_LOCK_FAIL] = "lock-fail",
+    [TRACE_VALIDATE_FAIL] = "validate-fail",
+    [TRACE_ABORT] = "abort",
+    [TRACE_COMMIT] = "commit",
+};
+
+static inline uint64_t trace_tsc(void){
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline uint64_t trace_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// only sets a flag, the next recorded event performs the dump
+static void trace_signal_handler(int unused(signal_number)){
+    atomic_fetch_add(&trace_signal_requests, 1);
+}
+
+static bool trace_signal_install(int signal_number){
+    if (signal_number <= 0 || signal_number >= NSIG){
+        return false;
+    }
+    bool installed = true;
+    park_lock_acquire(&trace_signal_lock);
+    if (trace_signal_users[signal_number] == 0){
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = trace_signal_handler;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        installed = sigaction(signal_number, &action, &trace_signal_previous[signal_number]) == 0;
+    }
+    if (installed){
+        trace_signal_users[signal_number]++;
+    }
+    park_lock_release(&trace_signal_lock);
+    return installed;
+}
+
+static void trace_signal_uninstall(int signal_number){
+    park_lock_acquire(&trace_signal_lock);
+    if (--trace_signal_users[signal_number] == 0){
+        sigaction(signal_number, &trace_signal_previous[signal_number], NULL);
+    }
+    park_lock_release(&trace_signal_lock);
+}
+
+trace_buffer* trace_create(int signal_number){
+    trace_buffer* trace = calloc(1, sizeof(trace_buffer));
+    if (unlikely(trace == NULL)){
+        return NULL;
+    }
+    trace->tsc_origin = trace_tsc();
+    trace->ns_origin = trace_ns();
+    atomic_store(&trace->dump_requests, atomic_load(&trace_signal_requests));
+
+    if (signal_number != 0 && !trace_signal_install(signal_number)){
+        free(trace);
+        return NULL;
+    }
+    trace->signal_number = signal_number;
+    return trace;
+}
+
+void trace_destroy(trace_buffer* trace){
+    if (trace == NULL){
+        return;
+    }
+    if (trace->signal_number != 0){
+        trace_signal_uninstall(trace->signal_number);
+    }
+    for (int i = 0; i < TRACE_RINGS; i++){
+        free(atomic_load(&trace->rings[i]));
+    }
+    free(trace);
+}
+
+void trace_record_slow(shared_rgn* region, trace_event_type type, uintptr_t tx, version_lock* lock, int32_t version){
+    trace_buffer* trace = region->trace;
+    _Atomic(trace_ring*)* slot = &trace->rings[thread_slot() % TRACE_RINGS];
+
+    trace_ring* ring = atomic_load_explicit(slot, memory_order_acquire);
+    if (unlikely(ring == NULL)){
+        trace_ring* fresh = calloc(1, sizeof(trace_ring));
+        if (unlikely(fresh == NULL)){
+            return;
+        }
+        if (atomic_compare_exchange_strong(slot, &ring, fresh)){
+            ring = fresh;
+        } else {
+            free(fresh); // another thread of this slot installed one
+        }
+    }
+
+    uint64_t index = atomic_fetch_add_explicit(&ring->head, 1, memory_order_relaxed);
+    trace_event* event = &ring->events[index & (TRACE_RING_SIZE - 1)];
+    event->tsc = trace_tsc();
+    event->tx = tx;
+    event->lock = lock == NULL ? UINT32_MAX : (uint32_t)(lock - region->locks);
+    event->version = version;
+    event->type = type;
+
+    // serve a pending signal dump request, one thread per request
+    unsigned int requests = atomic_load_explicit(&trace_signal_requests, memory_order_relaxed);
+    unsigned int served = atomic_load_explicit(&trace->dump_requests, memory_order_relaxed);
+    if (unlikely(requests != served) && atomic_compare_exchange_strong(&trace->dump_requests, &served, requests)){
+        char path[4096];
+        snprintf(path, sizeof(path), "%s.%u", region->options.trace_path, requests);
+        trace_dump(trace, region, path);
+    }
+}
+
+static void trace_write_event(FILE* out, bool* first, trace_event const* event, unsigned int tid, uint64_t tsc_origin, double ns_per_tick){
+    double ts = (double)(event->tsc - tsc_origin) * ns_per_tick / 1000.0; // microseconds
+    const char* name = event->type <= TRACE_COMMIT ? trace_event_names[event->type] : "unknown";
+
+    fprintf(out, "%s\n", *first ? "" : ",");
+    *first = false;
+    if (event->type == TRACE_BEGIN){
+        fprintf(out, "{\"name\":\"tx\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u,\"args\":{\"tx\":\"0x%lx\"}}",
+                ts, (int)getpid(), tid, (unsigned long)event->tx);
+        return;
+    }
+    if (event->type != TRACE_COMMIT){
+        // instant marker so that aborts stand out on the timeline
+        fprintf(out, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u,\"args\":{\"tx\":\"0x%lx\",\"lock\":%d,\"observed\":%d}},\n",
+                name, ts, (int)getpid(), tid, (unsigned long)event->tx,
+                event->lock == UINT32_MAX ? -1 : (int)event->lock, event->version);
+    }
+    fprintf(out, "{\"name\":\"tx\",\"ph\":\"E\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u,\"args\":{\"outcome\":\"%s\",\"%s\":%d}}",
+            ts, (int)getpid(), tid, name, event->type == TRACE_COMMIT ? "version" : "observed", event->version);
+}
+
+bool trace_dump(trace_buffer* trace, shared_rgn* unused(region), char const* path){
+    FILE* out = fopen(path, "w");
+    if (out == NULL){
+        return false;
+    }
+
+    // tsc to wall clock ratio measured over the whole tracing period
+    uint64_t tsc_elapsed = trace_tsc() - trace->tsc_origin;
+    uint64_t ns_elapsed = trace_ns() - trace->ns_origin;
+    double ns_per_tick = tsc_elapsed == 0 ? 1.0 : (double)ns_elapsed / (double)tsc_elapsed;
+
+    bool first = true;
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for (unsigned int tid = 0; tid < TRACE_RINGS; tid++){
+        trace_ring* ring = atomic_load_explicit(&trace->rings[tid], memory_order_acquire);
+        if (ring == NULL){
+            continue;
+        }
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t oldest = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+        for (uint64_t i = oldest; i < head; i++){
+            trace_write_event(out, &first, &ring->events[i & (TRACE_RING_SIZE - 1)], tid, trace->tsc_origin, ns_per_tick);
+        }
+    }
+    fprintf(out, "\n]}\n");
+    return fclose(out) == 0;
+}
@@ -4,16 +4,11 @@
 #include <stdbool.h>
 #include <utils.h>
 #include <stdio.h>
+#include <limits.h>
+#include <pthread.h>
 #include <dict.h>
 #include <tx_t.h>
-
-int nested_free_value_dict(void unused(*key), int unused(count), void* *value, void unused(*user)){
-    if(*value != NULL){
-        free(*value);
-    }
-    return 1;
-}
-
+#include <segment.h>
 
 int add_from_dict(void *key, int unused(count), void* *value, void *user){
     struct dictionary* dict = (struct dictionary*)user;
@@ -25,18 +20,6 @@ int add_from_dict(void *key, int unused(count), void* *value, void *user){
     return 1;
 }
 
-int rm_from_dict(void *key, int unused(count), void* unused(*value), void *user){
-    struct dictionary* dict = (struct dictionary*)user;
-    
-    if(dic_find(dict, key, 8) == 1){
-        dic_add(dict, key, 8);
-        free(*dict->value);
-        free(key);
-        *dict->value = NULL;
-    }
-    return 1;
-}
-
 int unique_lock_create(void *key, int unused(count), void* *unused(value), void *user){
     region_and_index* ri = (region_and_index*)user;
     struct dictionary* unique_lock_set = ri->key;
@@ -49,53 +32,55 @@ int unique_lock_create(void *key, int unused(count), void* *unused(value), void
 
 
 // lock up all words in the write set, can fail!
-int lock_unique_lock_set(void *key, int unused(count), void* *unused(value), void *user){
+// the value of each lock keeps the version it replaced, restored on rollback
+int lock_unique_lock_set(void *key, int unused(count), void* *value, void *user){
     region_and_index* ri = (region_and_index*)user;
     version_lock* lock = key;
-    int res_lock = lock_try_acquire(lock);
+    transaction_t* transaction = ri->transaction;
+    int previous = 0;
+    int res_lock = lock_try_acquire_owned(lock, transaction->lock_tag, transaction->read_version, &previous);
+
+    tm_backoff_t backoff = ri->region->options.backoff;
+    for(unsigned int attempt = 0; !res_lock && backoff != TM_BACKOFF_NONE && attempt < BACKOFF_ATTEMPTS; attempt++){
+        backoff_wait(backoff, attempt);
+        res_lock = lock_try_acquire_owned(lock, transaction->lock_tag, transaction->read_version, &previous);
+    }
     
     if(!res_lock){
         ri->key = lock;
         //printf("LOCK_WRITE_SET: failed lock on %p\n", lock);fflush(stdout);
         return res_lock;
     }
+    *value = (void*)(intptr_t)previous;
     //printf("LOCK_WRITE_SET: locked %p\n", lock);fflush(stdout);
     return res_lock;
 }
 
 // unlocks write set words until a match with the key in ri->key is found
-int unlock_unique_lock_set_until(void *key, int unused(count), void* *unused(value), void *user){
+int unlock_unique_lock_set_until(void *key, int unused(count), void* *value, void *user){
     region_and_index* ri = (region_and_index*)user;
     version_lock* lock = key;
     
     if (ri->key == lock) return 0; // if there is a stopping key release until a match is found
         
-    lock_release(lock);
+    lock_restore(lock, (int)(intptr_t)*value);
 
     return 1;
 }
 
-// in the ri the writing set is passed. all the keys that appear in the writing and reading set 
-// have to be transated to locks, checked for VERSION ONLY and subsiquently removed from reading set.
-// the keys appearing only in the reading set have to check both version and lock
+// all the keys of the reading set are translated to locks. a lock held by this transaction
+// carries its tag, it passes with a single compare unless the version it replaced was newer
+// than the snapshot; any other lock has to be free and not newer than the snapshot
 int validate_reading_set(void *key, int unused(count), void* *unused(value), void *user){
     region_and_index* ri = (region_and_index*)user;
-    struct dictionary* ws = (struct dictionary*)ri->key;
-
-    bool res = false;
 
     version_lock* lock = lock_get_from_pointer(ri->region, key);
-    if(dic_find(ws, key, 8)){
-        // key of rs is in ws, has already been locked
-        res = lock_check_version(lock, ri->transaction->read_version);
-
-    } else {
-        res = lock_check(lock, ri->transaction->read_version);
-    }
+    bool res = lock_check_owned(lock, ri->transaction->lock_tag, ri->transaction->read_version);
 
     if (res == false){
         //printf("VALIDATE READING SET: failed on key:%p, res:%d, with lock at:%p with value:%d and rv:%d\n", key, res, lock, *lock, ri->transaction->read_version);fflush(stdout);
         ri->transaction = NULL;
+        ri->key = lock;
         return 0;
     }
     //printf("VALIDATE READING SET: ok on key:%p, res:%d, with lock:%d and rv:%d\n", key, res, *lock, ri->transaction->read_version);fflush(stdout);
@@ -125,30 +110,150 @@ int update_unique_lock_set(void *key, int unused(count), void* *unused(value), v
     return 1;
 }
 
+// prefetches issued COMMIT_PREFETCH_DISTANCE entries ahead by tm_end, so that the misses
+// on the hashed lock table (and on the written words) overlap instead of being serial
 
-void dic_nested_destroy(struct dictionary* dic){
-    dic_forEach(dic, nested_free_value_dict, NULL);
-    dic_delete(dic);
+void prefetch_unique_lock(void *key, void unused(*user)){
+    __builtin_prefetch(key, 1);
+}
+
+void prefetch_reading_lock(void *key, void *user){
+    region_and_index* ri = (region_and_index*)user;
+    __builtin_prefetch(lock_get_from_pointer(ri->region, key), 0);
+}
+
+void prefetch_writing_word(void *key, void unused(*user)){
+    __builtin_prefetch(key, 1);
+}
+
+// small dense id of the calling thread, assigned on first use
+static _Atomic unsigned int thread_slot_next = 0;
+static _Thread_local unsigned int thread_slot_id = UINT_MAX;
+
+unsigned int thread_slot(void){
+    if (unlikely(thread_slot_id == UINT_MAX)){
+        thread_slot_id = atomic_fetch_add(&thread_slot_next, 1);
+    }
+    return thread_slot_id;
+}
+
+// spin before retrying a busy lock, attempt counts from 0
+void backoff_wait(tm_backoff_t policy, unsigned int attempt){
+    unsigned int spins = BACKOFF_SPIN_BASE;
+    if(policy == TM_BACKOFF_EXPONENTIAL){
+        spins = attempt < 16 ? BACKOFF_SPIN_BASE << attempt : BACKOFF_SPIN_MAX;
+        if(spins > BACKOFF_SPIN_MAX) spins = BACKOFF_SPIN_MAX;
+    }
+    for(unsigned int i = 0; i < spins; i++){
+        cpu_relax();
+    }
 }
 
-void tx_destroy(transaction_t* tx, bool committed){
-    dic_nested_destroy(tx->write_set);
-    dic_delete(tx->read_set);
 
+// forget the segments allocated by an ended transaction, freeing them if it aborted
+static void tx_release_allocs(transaction_t* tx, bool committed){
     if (!committed){
-        ll_destroy_nested(tx->alloc_set, free);
-    }else{
-        ll_destroy(tx->alloc_set);
+        // never published, no other transaction can reach them
+        for (segment_t* segment = tx->allocs; segment != NULL;){
+            segment_t* next = segment->next;
+            segment_release(segment);
+            segment = next;
+        }
+    }
+    tx->allocs = NULL;
+    tx->allocs_last = NULL;
+}
+
+transaction_t* tx_create(void){
+    transaction_t* tx = malloc(sizeof(transaction_t));
+    if (unlikely(tx == NULL)){
+        return NULL;
     }
+    tx->read_set = dic_new(0);
+    tx->write_set = dic_new(0);
+    tx->unique_locks = dic_new(0);
+    tx->allocs = NULL;
+    tx->allocs_last = NULL;
+    tx->free_set = malloc(sizeof(struct ll));
+    ll_init(tx->free_set);
+    return tx;
+}
+
+void tx_destroy(transaction_t* tx, bool committed){
+    dic_delete(tx->write_set);
+    dic_delete(tx->read_set);
+    dic_delete(tx->unique_locks);
+
+    tx_release_allocs(tx, committed);
+    ll_destroy(tx->free_set);
+    free(tx->free_set);
     
     free(tx);
     return;
 }
 
-static inline uint32_t hash_pointer(void *ptr) {
+// Descriptors of the transactions that last ended on this thread, emptied but with
+// their sets still sized, most recent last. Freed when the thread exits.
+typedef struct {
+    transaction_t* entries[TX_CACHE_SIZE];
+    unsigned int count;
+} tx_cache_t;
+
+static _Thread_local tx_cache_t tx_cache;
+static pthread_key_t tx_cache_key;
+static pthread_once_t tx_cache_once = PTHREAD_ONCE_INIT;
+
+static void tx_cache_flush(void* arg){
+    tx_cache_t* cache = arg;
+    for (unsigned int i = 0; i < cache->count; i++){
+        tx_destroy(cache->entries[i], true);
+    }
+    cache->count = 0;
+}
+
+static void tx_cache_key_create(void){
+    pthread_key_create(&tx_cache_key, tx_cache_flush);
+}
+
+// empty the sets of an ended transaction and keep it for reuse on this thread
+void tx_retire(transaction_t* tx, bool committed){
+    dic_reset(tx->write_set); // also releases the value copies
+    dic_reset(tx->read_set);
+    dic_reset(tx->unique_locks);
+    tx_release_allocs(tx, committed);
+    ll_clear(tx->free_set);
+
+    if (unlikely(tx_cache.count == TX_CACHE_SIZE)){
+        tx_destroy(tx, true);
+        return;
+    }
+    if (unlikely(tx_cache.count == 0)){
+        // register the thread-exit flush, once per thread
+        pthread_once(&tx_cache_once, tx_cache_key_create);
+        pthread_setspecific(tx_cache_key, &tx_cache);
+    }
+    tx_cache.entries[tx_cache.count++] = tx;
+}
+
+// take a retired descriptor of this thread: 'tx' if still kept, the most recent one if 'tx' is NULL
+transaction_t* tx_reuse(transaction_t* tx){
+    for (unsigned int i = tx_cache.count; i-- > 0;){
+        if (tx == NULL || tx_cache.entries[i] == tx){
+            transaction_t* found = tx_cache.entries[i];
+            for (unsigned int j = i + 1; j < tx_cache.count; j++){
+                tx_cache.entries[j - 1] = tx_cache.entries[j];
+            }
+            tx_cache.count--;
+            return found;
+        }
+    }
+    return NULL;
+}
+
+static inline uint32_t hash_pointer(void *ptr, unsigned int shift) {
 	////printf("key is %p\n", ptr);fflush(stdout);
-	// Shift out alignment bits to get meaningful variation
-	uintptr_t val = (uintptr_t)ptr >> 3;
+	// Shift out the bits below the lock granularity to get meaningful variation
+	uintptr_t val = (uintptr_t)ptr >> shift;
 	// Mix the bits to distribute values better in smaller ranges
 	val ^= val >> 16;
 	val *= 0x85ebca6b;
@@ -160,7 +265,10 @@ static inline uint32_t hash_pointer(void *ptr) {
 }
 
 version_lock* lock_get_from_pointer(shared_rgn* shared, void* ptr){
-    uint32_t lock_array_idx = hash_pointer(ptr);
+    if (shared->lock_striped){
+        return &shared->locks[((uintptr_t)ptr >> shared->lock_shift) & shared->lock_mask];
+    }
+    uint32_t lock_array_idx = hash_pointer(ptr, shared->lock_shift);
 
-    return &shared->locks[lock_array_idx % LOCK_ARRAY_SIZE];
+    return &shared->locks[lock_array_idx & shared->lock_mask];
 }
\ No newline at end of file
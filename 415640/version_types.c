@@ -1,6 +1,18 @@
+// Requested features
+#define _GNU_SOURCE
+
 #include "version_types.h"
+#include "macros.h"
+#include "params.h"
 #include <stdlib.h>
 #include <stdio.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <sched.h>
+#endif
 
 bool lock_try_acquire(version_lock* lk){
     //printf("try_lock_acquire pointer:%p with val:%d\n", lk, *lk);
@@ -16,11 +28,13 @@ bool lock_try_acquire(version_lock* lk){
 
 void lock_acquire(version_lock* lk){
     int vl = 0;
-    do{
+    while(!atomic_compare_exchange_weak(lk, &vl, vl | 0x1)){
+        // blocked until acquire lock, polling without writing to the line
+        while(atomic_load_explicit(lk, memory_order_relaxed) != 0){
+            cpu_relax();
+        }
         vl = 0;
     }
-    while(!atomic_compare_exchange_weak(lk, &vl, vl | 0x1))
-    ; // blocked until acquire lock
     return;
 }
 
@@ -40,13 +54,30 @@ bool lock_check(version_lock* lk, int own_vl){
     return true;
 }
 
-bool lock_check_version(version_lock* lk, int own_vl){
+// take a free lock for the owner tag, keeping the replaced version in previous for lock_restore
+bool lock_try_acquire_owned(version_lock* lk, int tag, int own_vl, int* previous){
     int vl = atomic_load(lk);
-    
-    if ((vl >> 1) > (own_vl >> 1)){
+
+    if (vl & 0x1){
         return false;
     }
-    return true;
+    *previous = vl;
+    return atomic_compare_exchange_strong(lk, &vl, (vl >> 1) > (own_vl >> 1) ? tag | LOCK_STALE : tag);
+}
+
+// give back a lock taken with lock_try_acquire_owned without publishing a new version
+void lock_restore(version_lock* lk, int previous){
+    atomic_store(lk, previous);
+}
+
+// lock_check that also accepts the caller's own locks whose version was not newer than own_vl
+bool lock_check_owned(version_lock* lk, int tag, int own_vl){
+    int vl = atomic_load(lk);
+
+    if (vl == tag){
+        return true;
+    }
+    return !(vl & 0x1) && (vl >> 1) <= (own_vl >> 1);
 }
 
 void lock_update_and_release(version_lock* lk, int updated_version){
@@ -55,3 +86,115 @@ void lock_update_and_release(version_lock* lk, int updated_version){
 }
 
 
+
+static inline void park_wait(park_lock* lk, int value){
+#ifdef __linux__
+    syscall(SYS_futex, lk, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+#else
+    (void)lk; (void)value;
+    sched_yield();
+#endif
+}
+
+static inline void park_wake_one(park_lock* lk){
+#ifdef __linux__
+    syscall(SYS_futex, lk, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#else
+    (void)lk;
+#endif
+}
+
+void park_lock_acquire(park_lock* lk){
+    int state = 0;
+    if (likely(atomic_compare_exchange_strong(lk, &state, 1))){
+        return;
+    }
+    // the holder is likely running and about to release
+    for (int spin = 0; spin < PARK_SPIN; spin++){
+        cpu_relax();
+        state = 0;
+        if (atomic_load_explicit(lk, memory_order_relaxed) == 0 && atomic_compare_exchange_weak(lk, &state, 1)){
+            return;
+        }
+    }
+    // announce a waiter, then sleep until the lock word changes from 2
+    while (atomic_exchange(lk, 2) != 0){
+        park_wait(lk, 2);
+    }
+}
+
+void park_lock_release(park_lock* lk){
+    if (atomic_fetch_sub(lk, 1) != 1){
+        // there may be parked waiters, one of them takes over
+        atomic_store(lk, 0);
+        park_wake_one(lk);
+    }
+}
+
+// scalar equivalent of lock_check over a contiguous run of locks
+version_lock* lock_check_range_scalar(version_lock* first, size_t count, int own_vl){
+    for (size_t i = 0; i < count; i++){
+        if (!lock_check(&first[i], own_vl)){
+            return &first[i];
+        }
+    }
+    return NULL;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+// versions are even, so a lock passes iff its word is even and <= own_vl;
+// the vector loads of the atomic words are plain 4-byte aligned loads
+__attribute__((target("sse2")))
+version_lock* lock_check_range_sse2(version_lock* first, size_t count, int own_vl){
+    __m128i rv = _mm_set1_epi32(own_vl);
+    __m128i one = _mm_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4){
+        __m128i v = _mm_loadu_si128((__m128i const*)&first[i]);
+        __m128i bad = _mm_or_si128(_mm_cmpgt_epi32(v, rv), _mm_cmpeq_epi32(_mm_and_si128(v, one), one));
+        if (_mm_movemask_epi8(bad) != 0){
+            // the flagged lock may be fine again by now, the following blocks still need a check
+            version_lock* failed = lock_check_range_scalar(&first[i], 4, own_vl);
+            if (failed != NULL){
+                return failed;
+            }
+        }
+    }
+    return lock_check_range_scalar(&first[i], count - i, own_vl);
+}
+
+__attribute__((target("avx2")))
+version_lock* lock_check_range_avx2(version_lock* first, size_t count, int own_vl){
+    __m256i rv = _mm256_set1_epi32(own_vl);
+    __m256i one = _mm256_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8){
+        __m256i v = _mm256_loadu_si256((__m256i const*)&first[i]);
+        __m256i bad = _mm256_or_si256(_mm256_cmpgt_epi32(v, rv), _mm256_cmpeq_epi32(_mm256_and_si256(v, one), one));
+        if (!_mm256_testz_si256(bad, bad)){
+            // the flagged lock may be fine again by now, the following blocks still need a check
+            version_lock* failed = lock_check_range_scalar(&first[i], 8, own_vl);
+            if (failed != NULL){
+                return failed;
+            }
+        }
+    }
+    return lock_check_range_scalar(&first[i], count - i, own_vl);
+}
+#endif
+
+// best implementation for the running cpu
+lock_range_check_fn lock_check_range_select(void){
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")){
+        return lock_check_range_avx2;
+    }
+    if (__builtin_cpu_supports("sse2")){
+        return lock_check_range_sse2;
+    }
+#endif
+    return lock_check_range_scalar;
+}
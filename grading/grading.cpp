@@ -31,8 +31,17 @@
 #include <cstring>
 #include <deque>
 #include <exception>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
 #include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
 #include <variant>
 #include <vector>
 
@@ -487,45 +496,315 @@ static bool check_shortcuts(TransactionalLibrary& tl, Seed seed) {
 
 // -------------------------------------------------------------------------- //
 
+namespace Exception {
+EXCEPTION(Option, Any, "Invalid option");
+    EXCEPTION(OptionUnknown, Option, "Unknown option");
+    EXCEPTION(OptionValue, Option, "Invalid value for option");
+    EXCEPTION(OptionFile, Option, "Unable to read configuration file");
+}
+/** Run parameters, given as '--key=value' or '--key value' on the command line or as 'key = value' lines in configuration files.
+ * The last value given to a key wins, and every key given must be read.
+**/
+class Options final {
+private:
+    ::std::map<::std::string, ::std::string> values; // Last value given to each key
+    ::std::set<::std::string> mutable used;          // Keys read so far
+    ::std::string mutable culprit;                   // Key or file of the last error
+private:
+    /** Remove the leading and trailing blanks of a string.
+     * @param text String to trim
+     * @return Trimmed string
+    **/
+    static ::std::string trim(::std::string const& text) {
+        auto first = text.find_first_not_of(" \t\r");
+        if (first == ::std::string::npos)
+            return {};
+        return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+    }
+    /** Parse a value.
+     * @param text  Text to parse, entirely
+     * @param value Parsed value
+     * @return Whether the text was a valid value
+    **/
+    template<class Type> static bool parse(::std::string const& text, Type& value) {
+        if constexpr (::std::is_same_v<Type, ::std::string>) {
+            value = text;
+            return true;
+        } else if constexpr (::std::is_same_v<Type, bool>) {
+            value = text == "yes" || text == "true" || text == "1";
+            return value || text == "no" || text == "false" || text == "0";
+        } else {
+            if (::std::is_unsigned_v<Type> && text.find('-') != ::std::string::npos) // Streams wrap negative unsigned values around
+                return false;
+            ::std::istringstream stream{text};
+            char rest;
+            return (stream >> value) && !(stream >> rest);
+        }
+    }
+public:
+    /** Set the value of a key.
+     * @param key   Key to set
+     * @param value Value to give
+    **/
+    void set(::std::string const& key, ::std::string const& value) {
+        values[key] = value;
+    }
+    /** Set the values of a configuration file, made of 'key = value' lines, blank lines and '#' comments.
+     * @param path Path of the configuration file
+    **/
+    void load(::std::string const& path) {
+        ::std::ifstream file{path};
+        if (unlikely(!file)) {
+            culprit = path;
+            throw Exception::OptionFile{};
+        }
+        ::std::string line;
+        while (::std::getline(file, line)) {
+            line = line.substr(0, line.find('#'));
+            auto equal = line.find('=');
+            auto key = trim(line.substr(0, equal));
+            if (key.empty() && equal == ::std::string::npos)
+                continue;
+            if (unlikely(key.empty() || equal == ::std::string::npos))
+                fail(line);
+            set(key, trim(line.substr(equal + 1)));
+        }
+    }
+    /** Get the value of a key.
+     * @param key Key to read
+     * @param def Default value, if the key was not given
+     * @param min Minimum valid value
+     * @param max Maximum valid value
+     * @return Given or default value
+    **/
+    template<class Type> Type get(char const* key, Type def, Type min = ::std::numeric_limits<Type>::lowest(), Type max = ::std::numeric_limits<Type>::max()) const {
+        used.insert(key);
+        auto entry = values.find(key);
+        if (entry == values.end())
+            return def;
+        Type value;
+        if (unlikely(!parse(entry->second, value) || value < min || value > max))
+            fail(key);
+        return value;
+    }
+    /** Get the value of a string key.
+     * @param key Key to read
+     * @param def Default value, if the key was not given
+     * @return Given or default value
+    **/
+    ::std::string get(char const* key, char const* def) const {
+        used.insert(key);
+        auto entry = values.find(key);
+        return entry == values.end() ? def : entry->second;
+    }
+    /** Report an invalid value.
+     * @param key Key of the value
+    **/
+    [[noreturn]] void fail(::std::string const& key) const {
+        culprit = key;
+        throw Exception::OptionValue{};
+    }
+    /** Check that every given key was read.
+    **/
+    void check_used() const {
+        for (auto&& entry: values) {
+            if (unlikely(used.count(entry.first) == 0)) {
+                culprit = entry.first;
+                throw Exception::OptionUnknown{};
+            }
+        }
+    }
+    /** Get the key or file of the last error.
+     * @return Key or file name
+    **/
+    auto const& get_culprit() const noexcept {
+        return culprit;
+    }
+};
+
+// -------------------------------------------------------------------------- //
+
 /** Program entry point.
  * @param argc Arguments count
  * @param argv Arguments values
  * @return Program return code
 **/
 int main(int argc, char** argv) {
+    auto const self = argc > 0 ? argv[0] : "grading";
+    Options options;
+    auto usage = [&]() {
+        ::std::cout << "Usage: " << self << " [--config <file>] [--restart] [--workload bank|hashmap|list|skiplist|rbtree|queue|ycsb-a...ycsb-f] [--<key>=<value>]... <seed> <reference library path> <tested library path>..." << ::std::endl;
+        ::std::cout << "Keys: threads tx-per-worker repeats slow-factor" << ::std::endl;
+        ::std::cout << "      accounts expected-accounts init-balance prob-long prob-alloc bank-theta prob-hot hot-fraction transfers (bank)" << ::std::endl;
+        ::std::cout << "      keys buckets prob-get prob-put prob-remove (hashmap), list-keys skiplist-keys prob-update (list, skiplist)" << ::std::endl;
+        ::std::cout << "      tree-keys prob-lookup prob-insert prob-delete (rbtree), producers queue-batch (queue)" << ::std::endl;
+        ::std::cout << "      records fields scan-length ycsb-theta ycsb-distribution (ycsb-*)" << ::std::endl;
+        return 1;
+    };
     try {
         // Parse command line option(s)
-        if (argc < 3) {
-            ::std::cout << "Usage: " << (argc > 0 ? argv[0] : "grading") << " <seed> <reference library path> <tested library path>..." << ::std::endl;
-            return 1;
+        while (argc > 1 && ::std::string{argv[1]}.rfind("--", 0) == 0) {
+            ::std::string option{argv[1] + 2};
+            ::std::string value;
+            auto equal = option.find('=');
+            if (equal != ::std::string::npos) { // '--key=value'
+                value = option.substr(equal + 1);
+                option.resize(equal);
+            } else if (option == "restart") { // Restart aborted transactions in place ('tm_restart')
+                value = "yes";
+            } else if (argc > 2) { // '--key value'
+                value = argv[2];
+                --argc;
+                ++argv;
+            } else {
+                argc = 0;
+                break;
+            }
+            if (option == "config") { // Configuration file, overridden by the options after it
+                options.load(value);
+            } else {
+                options.set(option, value);
+            }
+            --argc;
+            ++argv;
         }
-        // Get/set/compute run parameters
-        auto const nbworkers = []() {
+        if (argc < 3)
+            return usage();
+        // Get/set/compute run parameters (command line and configuration file values override the defaults below)
+        auto const restart       = options.get("restart", false);
+        auto const workload_name = options.get("workload", "bank");
+        auto const ycsb = workload_name.size() == 6 && workload_name.rfind("ycsb-", 0) == 0 && workload_name[5] >= 'a' && workload_name[5] <= 'f';
+        if (workload_name != "bank" && workload_name != "hashmap" && workload_name != "list" && workload_name != "skiplist" && workload_name != "rbtree" && workload_name != "queue" && !ycsb)
+            options.fail("workload");
+        auto const nbworkers = options.get("threads", []() {
             auto res = ::std::thread::hardware_concurrency();
             if (unlikely(res == 0))
                 res = 16;
             return static_cast<size_t>(res);
-        }();
-        auto const nbtxperwrk    = 200000ul / nbworkers;
-        auto const nbaccounts    = 32 * nbworkers;
-        auto const expnbaccounts = 256 * nbworkers;
-        auto const init_balance  = 100ul;
-        auto const prob_long     = 0.5f;
-        auto const prob_alloc    = 0.01f;
-        auto const nbrepeats     = 7;
+        }(), size_t{1});
+        auto const nbtxperwrk    = options.get("tx-per-worker", 200000ul / nbworkers, 1ul);
+        auto const nbrepeats     = options.get("repeats", 7u, 1u);
         auto const seed          = static_cast<Seed>(::std::stoul(argv[1]));
         auto const clk_res       = Chrono::get_resolution();
-        auto const slow_factor   = 8ul;
+        auto const slow_factor   = options.get("slow-factor", 8ul, 1ul);
+        // Only the keys of the selected workload are read, so 'check_used' rejects the keys of the others
+        ::std::function<void()> print_workload; // Print the workload parameters
+        ::std::function<::std::unique_ptr<Workload>(TransactionalLibrary const&)> make_workload; // Instantiate the workload
+        if (workload_name == "bank") {
+            auto const nbaccounts    = options.get("accounts", 32 * nbworkers, size_t{1});
+            auto const expnbaccounts = options.get("expected-accounts", 256 * nbworkers, size_t{1});
+            auto const init_balance  = options.get("init-balance", 100ul, 1ul);
+            auto const prob_long     = options.get("prob-long", 0.5f, 0.f, 1.f);
+            auto const prob_alloc    = options.get("prob-alloc", 0.01f, 0.f, 1.f);
+            auto const bank_theta    = options.get("bank-theta", 0., 0.);
+            auto const prob_hot      = options.get("prob-hot", 0.f, 0.f, 1.f);
+            auto const hot_fraction  = options.get("hot-fraction", 0.1f, 0.f, 1.f);
+            auto const nbtransfers   = options.get("transfers", 1ul, 1ul);
+            if (!(bank_theta < 1.))
+                options.fail("bank-theta");
+            print_workload = [=]() {
+                ::std::cout << "⎪ Initial #accounts:   " << nbaccounts << ::std::endl;
+                ::std::cout << "⎪ Expected #accounts:  " << expnbaccounts << ::std::endl;
+                ::std::cout << "⎪ Initial balance:     " << init_balance << ::std::endl;
+                ::std::cout << "⎪ Long TX probability: " << prob_long << ::std::endl;
+                ::std::cout << "⎪ Allocation TX prob.: " << prob_alloc << ::std::endl;
+                if (bank_theta > 0) {
+                    ::std::cout << "⎪ Account skew:        zipfian (theta " << bank_theta << ")" << ::std::endl;
+                } else if (prob_hot > 0) {
+                    ::std::cout << "⎪ Account skew:        hot set (" << hot_fraction << " of the accounts, probability " << prob_hot << ")" << ::std::endl;
+                }
+                if (nbtransfers != 1)
+                    ::std::cout << "⎪ Transfers per TX:    " << nbtransfers << ::std::endl;
+            };
+            make_workload = [=](TransactionalLibrary const& tl) {
+                return ::std::make_unique<WorkloadBank>(tl, nbworkers, nbtxperwrk, nbaccounts, expnbaccounts, init_balance, prob_long, prob_alloc, bank_theta, prob_hot, hot_fraction, nbtransfers);
+            };
+        } else if (workload_name == "hashmap") {
+            auto const nbkeys        = options.get("keys", 1024 * nbworkers, size_t{1});
+            auto const nbbuckets     = options.get("buckets", 256 * nbworkers, size_t{1});
+            auto const prob_get      = options.get("prob-get", 0.8f, 0.f, 1.f);
+            auto const prob_put      = options.get("prob-put", 0.1f, 0.f, 1.f);
+            auto const prob_remove   = options.get("prob-remove", 0.1f, 0.f, 1.f);
+            print_workload = [=]() {
+                ::std::cout << "⎪ #keys:               " << nbkeys << ::std::endl;
+                ::std::cout << "⎪ #buckets:            " << nbbuckets << ::std::endl;
+                ::std::cout << "⎪ Get/put/remove:      " << prob_get << "/" << prob_put << "/" << prob_remove << ::std::endl;
+            };
+            make_workload = [=](TransactionalLibrary const& tl) {
+                return ::std::make_unique<WorkloadHashMap>(tl, nbworkers, nbtxperwrk, nbkeys, nbbuckets, prob_get, prob_put, prob_remove);
+            };
+        } else if (workload_name == "list" || workload_name == "skiplist") {
+            auto const skiplist      = workload_name == "skiplist";
+            auto const nblistkeys    = skiplist ? options.get("skiplist-keys", 16384ul, 1ul) : options.get("list-keys", 256ul, 1ul);
+            auto const prob_update   = options.get("prob-update", 0.2f, 0.f, 1.f);
+            print_workload = [=]() {
+                ::std::cout << "⎪ #keys:               " << nblistkeys << ::std::endl;
+                ::std::cout << "⎪ Update probability:  " << prob_update << ::std::endl;
+            };
+            make_workload = [=](TransactionalLibrary const& tl) -> ::std::unique_ptr<Workload> {
+                if (skiplist)
+                    return ::std::make_unique<WorkloadSkipList>(tl, nbworkers, nbtxperwrk, nblistkeys, prob_update);
+                return ::std::make_unique<WorkloadList>(tl, nbworkers, nbtxperwrk, nblistkeys, prob_update);
+            };
+        } else if (workload_name == "rbtree") {
+            auto const nbtreekeys    = options.get("tree-keys", 1024ul, 1ul);
+            auto const prob_lookup   = options.get("prob-lookup", 0.6f, 0.f, 1.f);
+            auto const prob_insert   = options.get("prob-insert", 0.2f, 0.f, 1.f);
+            auto const prob_delete   = options.get("prob-delete", 0.2f, 0.f, 1.f);
+            print_workload = [=]() {
+                ::std::cout << "⎪ #keys:               " << nbtreekeys << ::std::endl;
+                ::std::cout << "⎪ Lookup/ins./delete:  " << prob_lookup << "/" << prob_insert << "/" << prob_delete << ::std::endl;
+            };
+            make_workload = [=](TransactionalLibrary const& tl) {
+                return ::std::make_unique<WorkloadRBTree>(tl, nbworkers, nbtxperwrk, nbtreekeys, prob_lookup, prob_insert, prob_delete);
+            };
+        } else if (workload_name == "queue") {
+            auto const nbproducers   = options.get("producers", ::std::max<size_t>(1, nbworkers / 2), size_t{1});
+            auto const queue_batch   = options.get("queue-batch", 4ul, 1ul);
+            print_workload = [=]() {
+                ::std::cout << "⎪ Producers/consumers: " << nbproducers << "/" << (nbworkers > 1 ? nbworkers - nbproducers : 1) << ::std::endl;
+                ::std::cout << "⎪ Batch size:          " << queue_batch << ::std::endl;
+            };
+            make_workload = [=](TransactionalLibrary const& tl) {
+                return ::std::make_unique<WorkloadQueue>(tl, nbworkers, nbtxperwrk, nbproducers, queue_batch);
+            };
+        } else { // YCSB
+            auto const nbrecords     = options.get("records", 1024 * nbworkers, size_t{1});
+            auto const ycsb_fields   = options.get("fields", 4ul, 1ul);
+            auto const ycsb_scanlen  = options.get("scan-length", 16ul, 1ul);
+            auto       ycsb_mix      = WorkloadYCSB::preset(workload_name[5]);
+            auto const ycsb_theta    = options.get("ycsb-theta", 0.99, 0.);
+            auto const ycsb_distrib  = options.get("ycsb-distribution", WorkloadYCSB::name(ycsb_mix.distribution));
+            for (auto distribution: {WorkloadYCSB::Distribution::uniform, WorkloadYCSB::Distribution::zipfian, WorkloadYCSB::Distribution::latest}) {
+                if (ycsb_distrib == WorkloadYCSB::name(distribution))
+                    ycsb_mix.distribution = distribution;
+            }
+            if (ycsb_distrib != WorkloadYCSB::name(ycsb_mix.distribution))
+                options.fail("ycsb-distribution");
+            if (!(ycsb_theta < 1.))
+                options.fail("ycsb-theta");
+            print_workload = [=]() {
+                ::std::cout << "⎪ Initial #records:    " << nbrecords << ::std::endl;
+                ::std::cout << "⎪ #fields per record:  " << ycsb_fields << ::std::endl;
+                ::std::cout << "⎪ Read/upd./RMW/scan/insert: " << ycsb_mix.read << "/" << ycsb_mix.update << "/" << ycsb_mix.rmw << "/" << ycsb_mix.scan << "/" << ycsb_mix.insert << ::std::endl;
+                ::std::cout << "⎪ Max. scan length:    " << ycsb_scanlen << ::std::endl;
+                ::std::cout << "⎪ Key distribution:    " << WorkloadYCSB::name(ycsb_mix.distribution) << " (theta " << ycsb_theta << ")" << ::std::endl;
+            };
+            make_workload = [=](TransactionalLibrary const& tl) {
+                return ::std::make_unique<WorkloadYCSB>(tl, nbworkers, nbtxperwrk, nbrecords, ycsb_fields, ycsb_scanlen, ycsb_mix, ycsb_theta);
+            };
+        }
+        options.check_used();
         // Print run parameters
         ::std::cout << "⎧ #worker threads:     " << nbworkers << ::std::endl;
         ::std::cout << "⎪ #TX per worker:      " << nbtxperwrk << ::std::endl;
         ::std::cout << "⎪ #repetitions:        " << nbrepeats << ::std::endl;
-        ::std::cout << "⎪ Initial #accounts:   " << nbaccounts << ::std::endl;
-        ::std::cout << "⎪ Expected #accounts:  " << expnbaccounts << ::std::endl;
-        ::std::cout << "⎪ Initial balance:     " << init_balance << ::std::endl;
-        ::std::cout << "⎪ Long TX probability: " << prob_long << ::std::endl;
-        ::std::cout << "⎪ Allocation TX prob.: " << prob_alloc << ::std::endl;
+        if (workload_name != "bank")
+            ::std::cout << "⎪ Workload:            " << workload_name << ::std::endl;
+        print_workload();
         ::std::cout << "⎪ Slow trigger factor: " << slow_factor << ::std::endl;
+        if (restart)
+            ::std::cout << "⎪ In-place restart:    yes" << ::std::endl;
         ::std::cout << "⎪ Clock resolution:    ";
         if (unlikely(clk_res == Chrono::invalid_tick)) {
             ::std::cout << "<unknown>" << ::std::endl;
@@ -542,12 +821,12 @@ int main(int argc, char** argv) {
         for (auto i = 2; i < argc; ++i) {
             ::std::cout << "⎧ Evaluating '" << argv[i] << "'" << (maxtick_init == Chrono::invalid_tick ? " (reference)" : "") << "..." << ::std::endl;
             // Load TM library
-            TransactionalLibrary tl{argv[i]};
+            TransactionalLibrary tl{argv[i], restart};
             // Initialize workload (shared memory lifetime bound to workload: created and destroyed at the same time)
-            WorkloadBank bank{tl, nbworkers, nbtxperwrk, nbaccounts, expnbaccounts, init_balance, prob_long, prob_alloc};
+            auto const workload = make_workload(tl);
             try {
                 // Actual performance measurements and correctness check
-                auto res = measure(bank, nbworkers, nbrepeats, seed, maxtick_init, maxtick_perf, maxtick_chck);
+                auto res = measure(*workload, nbworkers, nbrepeats, seed, maxtick_init, maxtick_perf, maxtick_chck);
                 // Check false negative-free correctness
                 auto error = ::std::get<0>(res);
                 if (unlikely(error)) {
@@ -575,6 +854,8 @@ int main(int argc, char** argv) {
                     ::std::cout << " -> " << (reference / perfdbl) << " speedup";
                 }
                 ::std::cout << ::std::endl;
+                if (workload->operations() > 0)
+                    ::std::cout << "⎪ Throughput:          " << (static_cast<double>(workload->operations()) * 1000000000. / perfdbl) << " op/s" << ::std::endl;
                 ::std::cout << "⎩ Average TX execution time: " << (perfdbl / pertxdiv) << " ns" << ::std::endl;
                 if (i == argc - 1) { // We run additional checks on the last implementation.
                     ::std::cout << "⎧ Checking whether '" << argv[i] << "' took shortcuts..." << ::std::endl;
@@ -596,6 +877,9 @@ int main(int argc, char** argv) {
             }
         }
         return 0;
+    } catch (Exception::Option const& err) {
+        ::std::cout << err.what() << " '" << options.get_culprit() << "'" << ::std::endl;
+        return usage();
     } catch (::std::exception const& err) {
         ::std::cerr << "⎧ *** EXCEPTION ***" << ::std::endl;
         ::std::cerr << "⎩ " << err.what() << ::std::endl;
@@ -80,6 +80,7 @@ private:
     using FnWrite   = decltype(&STM::tm_write);
     using FnAlloc   = decltype(&STM::tm_alloc);
     using FnFree    = decltype(&STM::tm_free);
+    using FnRestart = bool (*)(STM::shared_t, STM::tx_t, bool); // Optional extension, not in 'tm.h'
 private:
     void*     module;     // Module opaque handler
     FnCreate  tm_create;  // Module's initialization function
@@ -93,6 +94,7 @@ private:
     FnWrite   tm_write;   // Module's shared memory write function
     FnAlloc   tm_alloc;   // Module's shared memory allocation function
     FnFree    tm_free;    // Module's shared memory freeing function
+    FnRestart tm_restart; // Module's in-place transaction restart function (nullptr if unused or unavailable)
 private:
     /** Solve a symbol from its name, and bind it to the given function.
      * @param name Name of the symbol to resolve
@@ -109,9 +111,10 @@ private:
     }
 public:
     /** Loader constructor.
-     * @param path  Path to the library to load
+     * @param path    Path to the library to load
+     * @param restart Whether to restart aborted transactions in place, when the library exports 'tm_restart'
     **/
-    TransactionalLibrary(char const* path) {
+    TransactionalLibrary(char const* path, bool restart = false) {
         { // Resolve path and load module
             char resolved[PATH_MAX];
             if (unlikely(!realpath(path, resolved)))
@@ -132,6 +135,8 @@ public:
             solve("tm_write", tm_write);
             solve("tm_alloc", tm_alloc);
             solve("tm_free", tm_free);
+            auto res = restart ? ::dlsym(module, "tm_restart") : nullptr;
+            tm_restart = *reinterpret_cast<FnRestart*>(&res);
         }
     }
     /** Unloader destructor.
@@ -213,6 +218,14 @@ public:
     auto begin(bool ro) const noexcept {
         return tl.tm_begin(shared, ro);
     }
+    /** [thread-safe] Restart an aborted transaction in place, if the library supports it.
+     * @param tx Opaque ID of the aborted transaction
+     * @param ro Whether the restarted transaction is read-only
+     * @return Whether the transaction restarted, 'begin' must be used otherwise
+    **/
+    auto restart(TX tx, bool ro) const noexcept {
+        return tl.tm_restart && tl.tm_restart(shared, tx, ro);
+    }
     /** [thread-safe] End the given transaction.
      * @param tx Opaque transaction ID
      * @return Whether the whole transaction is a success
@@ -272,6 +285,7 @@ public:
 private:
     TransactionalMemory const& tm; // Bound transactional memory
     STM::tx_t tx; // Opaque transaction handle
+    STM::tx_t* retry; // Receives the handle on abort, for an in-place restart (optional)
     bool aborted; // Transaction was aborted
     bool is_ro;   // Whether the transaction is read-only (solely for assertion)
 public:
@@ -280,10 +294,16 @@ public:
     Transaction(Transaction const&) = delete;
     Transaction& operator=(Transaction const&) = delete;
     /** Begin constructor.
-     * @param tm Transactional memory to bind
-     * @param ro Whether the transaction is read-only
-    **/
-    Transaction(TransactionalMemory const& tm, Mode ro): tm{tm}, tx{tm.begin(static_cast<bool>(ro))}, aborted{false}, is_ro{static_cast<bool>(ro)} {
+     * @param tm    Transactional memory to bind
+     * @param ro    Whether the transaction is read-only
+     * @param retry Handle of a previous aborted attempt to restart in place if possible, set to this transaction's handle if it aborts (optional)
+    **/
+    Transaction(TransactionalMemory const& tm, Mode ro, STM::tx_t* retry = nullptr): tm{tm}, retry{retry}, aborted{false}, is_ro{static_cast<bool>(ro)} {
+        if (retry && *retry != STM::invalid_tx && tm.restart(*retry, is_ro)) {
+            tx = *retry;
+        } else {
+            tx = tm.begin(is_ro);
+        }
         if (unlikely(tx == STM::invalid_tx))
             throw Exception::TransactionBegin{};
     }
@@ -291,8 +311,13 @@ public:
     **/
     ~Transaction() noexcept(false) {
         if (likely(!aborted)) {
-            if (unlikely(!tm.end(tx)))
+            if (unlikely(!tm.end(tx))) {
+                if (retry)
+                    *retry = tx;
                 throw Exception::TransactionRetry{};
+            }
+        } else if (retry) {
+            *retry = tx;
         }
     }
 public:
@@ -609,9 +634,10 @@ public:
  * @return Returned value (or void) when the transaction committed
 **/
 template<class Func> static auto transactional(TransactionalMemory const& tm, Transaction::Mode mode, Func&& func) {
+    STM::tx_t retry = STM::invalid_tx; // Last aborted attempt, restarted in place when the library allows it
     do {
         try {
-            Transaction tx{tm, mode};
+            Transaction tx{tm, mode, &retry};
             return func(tx);
         } catch (Exception::TransactionRetry const&) {
             continue;
@@ -24,8 +24,12 @@
 #pragma once
 
 // External headers
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstdint>
 #include <random>
+#include <vector>
 
 // Internal headers
 #include "common.hpp"
@@ -77,6 +81,61 @@ public:
      * @return Constant null-terminated error message, 'nullptr' for none
     **/
     virtual char const* check(Uid, Seed) const = 0;
+    /** Number of workload-level operations of one 'run' of all the workers, for throughput reporting.
+     * @return Operation count, 0 if the workload does not report any
+    **/
+    virtual size_t operations() const {
+        return 0;
+    }
+};
+
+// -------------------------------------------------------------------------- //
+
+/** Zipfian distribution over [0, n), rank 0 the most popular (Gray et al., "Quickly generating billion-record synthetic databases").
+**/
+class ZipfianDistribution final {
+public:
+    /** Drawn rank class alias.
+    **/
+    using result_type = size_t;
+private:
+    size_t n;     // Number of ranks
+    double theta; // Skew, 0 for uniform
+    double zetan; // Sum of 1 / i^theta for i in [1, n]
+    double alpha; // 1 / (1 - theta)
+    double eta;   // Scaling of the uniform draw past the first two ranks
+public:
+    /** Distribution constructor, computing the normalization constant in O(n).
+     * @param n     Number of ranks (at least 1)
+     * @param theta Skew in [0, 1), 0.99 in YCSB
+    **/
+    ZipfianDistribution(size_t n, double theta): n{::std::max(n, size_t{1})}, theta{theta}, zetan{0.}, alpha{1. / (1. - theta)} {
+        for (size_t i = 1; i <= this->n; ++i)
+            zetan += 1. / ::std::pow(static_cast<double>(i), theta);
+        auto zeta2 = 1. + 1. / ::std::pow(2., theta);
+        eta = this->n > 2 ? (1. - ::std::pow(2. / static_cast<double>(this->n), 1. - theta)) / (1. - zeta2 / zetan) : 1.;
+    }
+public:
+    /** Get the number of ranks.
+     * @return Number of ranks
+    **/
+    size_t size() const noexcept {
+        return n;
+    }
+    /** Draw a rank.
+     * @param engine Randomness source
+     * @return Rank in [0, n)
+    **/
+    template<class Engine> size_t operator()(Engine& engine) const {
+        auto u = ::std::uniform_real_distribution<double>{0., 1.}(engine);
+        auto uz = u * zetan;
+        if (uz < 1.)
+            return 0;
+        if (uz < 1. + ::std::pow(0.5, theta))
+            return ::std::min(n - 1, size_t{1});
+        auto rank = static_cast<size_t>(static_cast<double>(n) * ::std::pow(eta * u - eta + 1., alpha));
+        return ::std::min(rank, n - 1);
+    }
 };
 
 // -------------------------------------------------------------------------- //
@@ -140,6 +199,10 @@ private:
     Balance init_balance;  // Initial account balance
     float   prob_long;     // Probability of running a long, read-only control transaction
     float   prob_alloc;    // Probability of running an allocation/deallocation transaction, knowing a long transaction won't run
+    float   prob_hot;      // Probability of picking an account in the hot set, when not Zipfian
+    float   hot_fraction;  // Fraction of the accounts, the first ones, making up the hot set
+    size_t  nbtransfers;   // Number of transfers per short transaction
+    ZipfianDistribution zipf; // Account popularity, the first accounts being the most popular (a single rank when theta is 0)
     Barrier barrier;       // Barrier for thread synchronization during 'check'
 public:
     /** Bank workload constructor.
@@ -151,8 +214,12 @@ public:
      * @param init_balance  Initial account balance
      * @param prob_long     Probability of running a long, read-only control transaction
      * @param prob_alloc    Probability of running an allocation/deallocation transaction, knowing a long transaction won't run
+     * @param theta         Zipfian skew in [0, 1) of the accounts picked by short transactions, 0 for none
+     * @param prob_hot      Probability of picking an account in the hot set, when theta is 0 (0 for uniform picks)
+     * @param hot_fraction  Fraction of the accounts, the first ones, making up the hot set
+     * @param nbtransfers   Number of transfers per short transaction
     **/
-    WorkloadBank(TransactionalLibrary const& library, size_t nbworkers, size_t nbtxperwrk, size_t nbaccounts, size_t expnbaccounts, Balance init_balance, float prob_long, float prob_alloc): Workload{library, AccountSegment::align(), AccountSegment::size(nbaccounts)}, nbworkers{nbworkers}, nbtxperwrk{nbtxperwrk}, nbaccounts{nbaccounts}, expnbaccounts{expnbaccounts}, init_balance{init_balance}, prob_long{prob_long}, prob_alloc{prob_alloc}, barrier{static_cast<Barrier::Counter>(nbworkers)} {}
+    WorkloadBank(TransactionalLibrary const& library, size_t nbworkers, size_t nbtxperwrk, size_t nbaccounts, size_t expnbaccounts, Balance init_balance, float prob_long, float prob_alloc, double theta, float prob_hot, float hot_fraction, size_t nbtransfers): Workload{library, AccountSegment::align(), AccountSegment::size(nbaccounts)}, nbworkers{nbworkers}, nbtxperwrk{nbtxperwrk}, nbaccounts{nbaccounts}, expnbaccounts{expnbaccounts}, init_balance{init_balance}, prob_long{prob_long}, prob_alloc{prob_alloc}, prob_hot{theta > 0 ? 0.f : prob_hot}, hot_fraction{hot_fraction}, nbtransfers{::std::max(nbtransfers, size_t{1})}, zipf{theta > 0 ? expnbaccounts : 1, theta}, barrier{static_cast<Barrier::Counter>(nbworkers)} {}
 private:
     /** Long read-only transaction, summing the balance of each account.
      * @param count Loosely-updated number of accounts
@@ -224,51 +291,59 @@ private:
             }
         });
     }
-    /** Short read-write transaction, transferring one unit from an account to an account (potentially the same).
-     * @param send_id Index of the sender account
-     * @param recv_id Index of the receiver account (potentially same as source)
+    /** Pick an account for a short transaction.
+     * @param engine Randomness source
+     * @param count  Loosely-updated number of accounts
+     * @return Index of the account
+    **/
+    template<class Engine> size_t pick(Engine& engine, size_t count) const {
+        if (zipf.size() > 1) // Zipfian, the most popular ranks being the first accounts, which always exist
+            return zipf(engine) % count;
+        if (prob_hot > 0 && ::std::bernoulli_distribution{prob_hot}(engine)) {
+            auto hot = ::std::max(static_cast<size_t>(hot_fraction * static_cast<float>(count)), size_t{1});
+            return ::std::uniform_int_distribution<size_t>{0, ::std::min(hot, count) - 1}(engine);
+        }
+        return ::std::uniform_int_distribution<size_t>{0, count - 1}(engine);
+    }
+    /** Short read-write transaction, transferring one unit from an account to an account (potentially the same), for each pair of accounts.
+     * @param ids  Indexes of the sender then receiver account of each transfer
+     * @param ptrs Private buffer of as many account pointers
      * @return Whether the parameters were satisfying and the transaction committed on useful work
     **/
-    bool short_tx(size_t send_id, size_t recv_id) const {
+    bool short_tx(::std::vector<size_t> const& ids, ::std::vector<void*>& ptrs) const {
         return transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
-            void* send_ptr = nullptr;
-            void* recv_ptr = nullptr;
+            auto missing = ids.size();
+            ::std::fill(ptrs.begin(), ptrs.end(), nullptr);
 
             // Get the account pointers in shared memory
             auto start = tm.get_start();
+            size_t base = 0; // Index of the first account of the current segment
             while (true) {
                 AccountSegment segment{tx, start};
                 size_t segment_count = segment.count;
-                if (!send_ptr) {
-                    if (send_id < segment_count) {
-                        send_ptr = segment.accounts[send_id].get();
-                        if (recv_ptr)
-                            break;
-                    } else {
-                        send_id -= segment_count;
-                    }
-                }
-                if (!recv_ptr) {
-                    if (recv_id < segment_count) {
-                        recv_ptr = segment.accounts[recv_id].get();
-                        if (send_ptr)
-                            break;
-                    } else {
-                        recv_id -= segment_count;
+                for (size_t i = 0; i < ids.size(); ++i) {
+                    if (!ptrs[i] && ids[i] - base < segment_count) { // Accounts of previous segments were resolved already
+                        ptrs[i] = segment.accounts[ids[i] - base].get();
+                        --missing;
                     }
                 }
+                if (missing == 0)
+                    break;
+                base += segment_count;
                 start = segment.next;
                 if (!start) // Current segment is the last segment
                     return false; // At least one account does not exist => do nothing
             }
 
             // Transfer the money if enough fund
-            Shared<Balance> sender{tx, send_ptr}; // Shared is a template that overloads copy to use tm_read/tm_write.
-            Shared<Balance> recver{tx, recv_ptr};
-            auto send_val = sender.read();
-            if (send_val > 0) {
-                sender = send_val - 1;
-                recver = recver.read() + 1;
+            for (size_t i = 0; i < ptrs.size(); i += 2) {
+                Shared<Balance> sender{tx, ptrs[i]}; // Shared is a template that overloads copy to use tm_read/tm_write.
+                Shared<Balance> recver{tx, ptrs[i + 1]};
+                auto send_val = sender.read();
+                if (send_val > 0) {
+                    sender = send_val - 1;
+                    recver = recver.read() + 1;
+                }
             }
             return true;
         });
@@ -303,6 +378,8 @@ public:
         ::std::bernoulli_distribution alloc_dist{prob_alloc};
         ::std::gamma_distribution<float> alloc_trigger(expnbaccounts, 1);
         size_t count = nbaccounts;
+        ::std::vector<size_t> ids(2 * nbtransfers);
+        ::std::vector<void*> ptrs(2 * nbtransfers);
         for (size_t cntr = 0; cntr < nbtxperwrk; ++cntr) {
             if (long_dist(engine)) { // We roll a dice and, if "lucky", run a long transaction.
                 if (unlikely(!long_tx(count))) // If it fails, then we return an error message.
@@ -310,8 +387,12 @@ public:
             } else if (alloc_dist(engine)) { // Let's roll a dice again to trigger an allocation transaction.
                 alloc_tx(alloc_trigger(engine));
             } else { // No luck with previous rolls, let's just run a short transaction.
-                ::std::uniform_int_distribution<size_t> account{0, count - 1};
-                while (unlikely(!short_tx(account(engine), account(engine))));
+                do {
+                    for (size_t i = 0; i < ids.size(); i += 2) { // Receiver first, the historical draw order
+                        ids[i + 1] = pick(engine, count);
+                        ids[i] = pick(engine, count);
+                    }
+                } while (unlikely(!short_tx(ids, ptrs)));
             }
         }
         { // Last long transaction
@@ -387,3 +468,1837 @@ public:
         return nullptr;
     }
 };
+
+// -------------------------------------------------------------------------- //
+
+/** Hash map workload class.
+**/
+class WorkloadHashMap final: public Workload {
+public:
+    /** Key and value classes alias.
+    **/
+    using Key   = uintptr_t;
+    using Value = uintptr_t;
+private:
+    /** Shared chaining node class, each allocated in its own segment.
+    **/
+    class Node final {
+    private:
+        /** Dummy structure for size and alignment retrieval.
+        **/
+        struct Dummy {
+            Key   dummy0;
+            Value dummy1;
+            void* dummy2;
+        };
+    public:
+        /** Get the node size.
+         * @return Node size (in bytes)
+        **/
+        constexpr static auto size() noexcept {
+            return sizeof(Dummy);
+        }
+        /** Get the node alignment.
+         * @return Node alignment (in bytes)
+        **/
+        constexpr static auto align() noexcept {
+            return alignof(Dummy);
+        }
+    public:
+        Shared<Key>   key;   // Key of the entry
+        Shared<Value> value; // Value of the entry
+        Shared<Node*> next;  // Next node in the same bucket
+    public:
+        /** Deleted copy constructor/assignment.
+        **/
+        Node(Node const&) = delete;
+        Node& operator=(Node const&) = delete;
+        /** Binding constructor.
+         * @param tx      Associated pending transaction
+         * @param address Block base address
+        **/
+        Node(Transaction& tx, void* address): key{tx, address}, value{tx, key.after()}, next{tx, value.after()} {}
+    };
+    /** Shared map header class, at the start of the shared memory region.
+    **/
+    class Header final {
+    public:
+        /** Get the header size.
+         * @return Header size (in bytes)
+        **/
+        constexpr static auto size() noexcept {
+            return sizeof(Node**);
+        }
+        /** Get the header alignment.
+         * @return Header alignment (in bytes)
+        **/
+        constexpr static auto align() noexcept {
+            return Node::align();
+        }
+    public:
+        Shared<Node**> buckets; // Array of bucket heads, allocated at initialization
+    public:
+        /** Deleted copy constructor/assignment.
+        **/
+        Header(Header const&) = delete;
+        Header& operator=(Header const&) = delete;
+        /** Binding constructor.
+         * @param tx      Associated pending transaction
+         * @param address Block base address
+        **/
+        Header(Transaction& tx, void* address): buckets{tx, address} {}
+    };
+private:
+    size_t  nbworkers;   // Number of concurrent workers
+    size_t  nbtxperwrk;  // Number of transactions per worker
+    size_t  nbkeys;      // Keys are drawn from [0, nbkeys)
+    size_t  nbbuckets;   // Number of buckets of the map
+    float   prob_get;    // Relative weight of lookups
+    float   prob_put;    // Relative weight of insertions/updates
+    float   prob_remove; // Relative weight of removals
+    Barrier barrier;     // Barrier for thread synchronization during 'check'
+public:
+    /** Hash map workload constructor.
+     * @param library     Transactional library to use
+     * @param nbworkers   Total number of concurrent threads (for both 'run' and 'check')
+     * @param nbtxperwrk  Number of transactions per worker
+     * @param nbkeys      Number of distinct keys
+     * @param nbbuckets   Number of buckets of the map
+     * @param prob_get    Relative weight of lookups
+     * @param prob_put    Relative weight of insertions/updates
+     * @param prob_remove Relative weight of removals
+    **/
+    WorkloadHashMap(TransactionalLibrary const& library, size_t nbworkers, size_t nbtxperwrk, size_t nbkeys, size_t nbbuckets, float prob_get, float prob_put, float prob_remove): Workload{library, Header::align(), Header::size()}, nbworkers{nbworkers}, nbtxperwrk{nbtxperwrk}, nbkeys{nbkeys}, nbbuckets{nbbuckets}, prob_get{prob_get}, prob_put{prob_put}, prob_remove{prob_remove}, barrier{static_cast<Barrier::Counter>(nbworkers)} {}
+private:
+    /** Bucket of a key.
+     * @param key Key to hash
+     * @return Bucket index
+    **/
+    size_t bucket_of(Key key) const noexcept {
+        return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9e3779b97f4a7c15ull) >> 17) % nbbuckets;
+    }
+    /** Value stored for a key, tagged so that a value found under another key is detected.
+     * @param key   Key of the entry
+     * @param stamp Arbitrary stamp
+     * @return Value to store
+    **/
+    Value value_of(Key key, size_t stamp) const noexcept {
+        return key + nbkeys * stamp;
+    }
+    /** Look a key up in a pending transaction.
+     * @param tx      Pending transaction
+     * @param buckets Bucket array
+     * @param key     Key to look for
+     * @param value   Set to the value of the key, if found
+     * @return Whether the key was found
+    **/
+    bool find(Transaction& tx, Node** buckets, Key key, Value& value) const {
+        Node* node = Shared<Node*>{tx, buckets + bucket_of(key)};
+        while (node) {
+            Node entry{tx, node};
+            if (entry.key == key) {
+                value = entry.value;
+                return true;
+            }
+            node = entry.next;
+        }
+        return false;
+    }
+    /** Insert or update a key in a pending transaction.
+     * @param tx      Pending transaction
+     * @param buckets Bucket array
+     * @param key     Key to insert
+     * @param value   Value to associate
+    **/
+    void put(Transaction& tx, Node** buckets, Key key, Value value) const {
+        Shared<Node*> head{tx, buckets + bucket_of(key)};
+        Node* first = head;
+        for (Node* node = first; node;) {
+            Node entry{tx, node};
+            if (entry.key == key) {
+                entry.value = value;
+                return;
+            }
+            node = entry.next;
+        }
+        auto fresh = reinterpret_cast<Node*>(tx.alloc(Node::size()));
+        Node entry{tx, fresh};
+        entry.key   = key;
+        entry.value = value;
+        entry.next  = first;
+        head = fresh;
+    }
+    /** Remove a key in a pending transaction, freeing its node.
+     * @param tx      Pending transaction
+     * @param buckets Bucket array
+     * @param key     Key to remove
+     * @return Whether the key was found
+    **/
+    bool remove(Transaction& tx, Node** buckets, Key key) const {
+        Node** link = buckets + bucket_of(key);
+        Node* node = Shared<Node*>{tx, link};
+        while (node) {
+            Node entry{tx, node};
+            if (entry.key == key) {
+                Shared<Node*>{tx, link} = entry.next.read();
+                tx.free(node);
+                return true;
+            }
+            link = entry.next.get();
+            node = entry.next;
+        }
+        return false;
+    }
+    /** Long read-only transaction, walking the whole map.
+     * @param count Set to the number of entries
+     * @param owner If true, check as well that each key holds the value written by 'check'
+     * @return Whether no inconsistency has been found
+    **/
+    bool scan_tx(size_t& count, bool owner) const {
+        return transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+            ::std::vector<bool> seen(nbkeys, false);
+            Node** buckets = Header{tx, tm.get_start()}.buckets;
+            count = 0;
+            for (size_t b = 0; b < nbbuckets; ++b) {
+                for (Node* node = Shared<Node*>{tx, buckets + b}; node;) {
+                    Node entry{tx, node};
+                    Key key = entry.key;
+                    Value value = entry.value;
+                    if (unlikely(key >= nbkeys || bucket_of(key) != b || seen[key] || value % nbkeys != key))
+                        return false;
+                    if (unlikely(owner && value != value_of(key, key % nbworkers + 1)))
+                        return false;
+                    seen[key] = true;
+                    ++count;
+                    node = entry.next;
+                }
+            }
+            return true;
+        });
+    }
+public:
+    /**
+     * Allocate the (empty) buckets, the first worker to get there does it, and insert key 0.
+    **/
+    virtual char const* init() const {
+        transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            Header header{tx, tm.get_start()};
+            if (header.buckets.read() != nullptr)
+                return;
+            put(tx, header.buckets.alloc(nbbuckets * sizeof(Node*)), 0, value_of(0, 0));
+        });
+        auto correct = transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+            Value value;
+            return find(tx, Header{tx, tm.get_start()}.buckets, 0, value) && value % nbkeys == 0;
+        });
+        if (unlikely(!correct))
+            return "Violated consistency (check that committed writes in shared memory get visible to the following transactions' reads)";
+        return nullptr;
+    }
+    /**
+     * Run nbtxperwrk random lookups, insertions and removals, then check the map structure.
+     * @param seed Randomness source
+    **/
+    virtual char const* run(Uid uid, Seed seed) const {
+        ::std::minstd_rand engine{seed};
+        ::std::discrete_distribution<int> op_dist{prob_get, prob_put, prob_remove};
+        ::std::uniform_int_distribution<Key> key_dist{0, nbkeys - 1};
+        for (size_t cntr = 0; cntr < nbtxperwrk; ++cntr) {
+            auto key = key_dist(engine);
+            switch (op_dist(engine)) {
+            case 0: {
+                auto correct = transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+                    Value value;
+                    return !find(tx, Header{tx, tm.get_start()}.buckets, key, value) || value % nbkeys == key;
+                });
+                if (unlikely(!correct))
+                    return "Violated isolation or atomicity";
+            } break;
+            case 1:
+                transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+                    put(tx, Header{tx, tm.get_start()}.buckets, key, value_of(key, uid + 1));
+                });
+                break;
+            default:
+                transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+                    remove(tx, Header{tx, tm.get_start()}.buckets, key);
+                });
+            }
+        }
+        size_t count;
+        if (unlikely(!scan_tx(count, false)))
+            return "Violated isolation or atomicity";
+        return nullptr;
+    }
+    /**
+     * Test in which each worker removes then reinserts its own share of the keys, and the first one checks the whole map.
+     * @param uid Id of the thread to run the check
+    **/
+    virtual char const* check(Uid uid, Seed seed [[gnu::unused]]) const {
+        char const* error = nullptr;
+        barrier.sync();
+        for (Key key = uid; key < nbkeys && !error; key += nbworkers) {
+            auto expected = value_of(key, key % nbworkers + 1);
+            transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+                remove(tx, Header{tx, tm.get_start()}.buckets, key);
+            });
+            auto absent = transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+                Value value;
+                return !find(tx, Header{tx, tm.get_start()}.buckets, key, value);
+            });
+            transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+                put(tx, Header{tx, tm.get_start()}.buckets, key, expected);
+            });
+            auto present = transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+                Value value;
+                return find(tx, Header{tx, tm.get_start()}.buckets, key, value) && value == expected;
+            });
+            if (unlikely(!absent || !present))
+                error = "Violated consistency, isolation or atomicity";
+        }
+        barrier.sync();
+        if (uid == 0 && !error) {
+            size_t count;
+            if (unlikely(!scan_tx(count, true) || count != nbkeys))
+                return "Violated consistency";
+        }
+        return error;
+    }
+};
+
+// -------------------------------------------------------------------------- //
+
+/** Sorted linked-list set workload class.
+**/
+class WorkloadList final: public Workload {
+public:
+    /** Key class alias.
+    **/
+    using Key = uintptr_t;
+private:
+    /** Shared list node class, each allocated in its own segment.
+    **/
+    class Node final {
+    private:
+        /** Dummy structure for size and alignment retrieval.
+        **/
+        struct Dummy {
+            Key   dummy0;
+            void* dummy1;
+        };
+    public:
+        /** Get the node size.
+         * @return Node size (in bytes)
+        **/
+        constexpr static auto size() noexcept {
+            return sizeof(Dummy);
+        }
+        /** Get the node alignment.
+         * @return Node alignment (in bytes)
+        **/
+        constexpr static auto align() noexcept {
+            return alignof(Dummy);
+        }
+    public:
+        Shared<Key>   key;  // Key of the element
+        Shared<Node*> next; // Next element, with a greater key
+    public:
+        /** Deleted copy constructor/assignment.
+        **/
+        Node(Node const&) = delete;
+        Node& operator=(Node const&) = delete;
+        /** Binding constructor.
+         * @param tx      Associated pending transaction
+         * @param address Block base address
+        **/
+        Node(Transaction& tx, void* address): key{tx, address}, next{tx, key.after()} {}
+    };
+private:
+    size_t  nbworkers;   // Number of concurrent workers
+    size_t  nbtxperwrk;  // Number of transactions per worker
+    size_t  nbkeys;      // Keys are drawn from [0, nbkeys), half of them are in the set at any time
+    float   prob_update; // Probability of running an insertion or a removal instead of a lookup
+    Barrier barrier;     // Barrier for thread synchronization during 'check'
+    ::std::atomic<Key> mutable prefill; // Next key to insert during 'init'
+public:
+    /** Sorted list workload constructor.
+     * @param library     Transactional library to use
+     * @param nbworkers   Total number of concurrent threads (for both 'run' and 'check')
+     * @param nbtxperwrk  Number of transactions per worker
+     * @param nbkeys      Number of distinct keys, half of them are inserted at initialization
+     * @param prob_update Probability of running an insertion or a removal instead of a lookup
+    **/
+    WorkloadList(TransactionalLibrary const& library, size_t nbworkers, size_t nbtxperwrk, size_t nbkeys, float prob_update): Workload{library, Node::align(), sizeof(Node*)}, nbworkers{nbworkers}, nbtxperwrk{nbtxperwrk}, nbkeys{nbkeys}, prob_update{prob_update}, barrier{static_cast<Barrier::Counter>(nbworkers)}, prefill{0} {}
+private:
+    /** Find the link to the first element not lower than a key, in a pending transaction.
+     * @param tx   Pending transaction
+     * @param key  Key to look for
+     * @param node Set to the element the link points to ('nullptr' at the end of the list)
+     * @return Address of the link (the list head or the 'next' field of the previous element)
+    **/
+    Node** locate(Transaction& tx, Key key, Node*& node) const {
+        auto link = reinterpret_cast<Node**>(tm.get_start());
+        node = Shared<Node*>{tx, link};
+        while (node) {
+            Node entry{tx, node};
+            if (entry.key >= key)
+                break;
+            link = entry.next.get();
+            node = entry.next;
+        }
+        return link;
+    }
+    /** Look a key up.
+     * @param key Key to look for
+     * @return Whether the key is in the set
+    **/
+    bool contains_tx(Key key) const {
+        return transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+            Node* node;
+            locate(tx, key, node);
+            return node && Node{tx, node}.key == key;
+        });
+    }
+    /** Insert a key.
+     * @param key Key to insert
+     * @return Whether the key was not in the set
+    **/
+    bool insert_tx(Key key) const {
+        return transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            Node* node;
+            auto link = locate(tx, key, node);
+            if (node && Node{tx, node}.key == key)
+                return false;
+            auto fresh = reinterpret_cast<Node*>(tx.alloc(Node::size()));
+            Node entry{tx, fresh};
+            entry.key  = key;
+            entry.next = node;
+            Shared<Node*>{tx, link} = fresh;
+            return true;
+        });
+    }
+    /** Remove a key, freeing its element.
+     * @param key Key to remove
+     * @return Whether the key was in the set
+    **/
+    bool remove_tx(Key key) const {
+        return transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            Node* node;
+            auto link = locate(tx, key, node);
+            if (!node)
+                return false;
+            Node entry{tx, node};
+            if (entry.key != key)
+                return false;
+            Shared<Node*>{tx, link} = entry.next.read();
+            tx.free(node);
+            return true;
+        });
+    }
+    /** Long read-only transaction, walking the whole list.
+     * @param count Set to the number of elements
+     * @return Whether the keys are strictly increasing and in range
+    **/
+    bool scan_tx(size_t& count) const {
+        return transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+            count = 0;
+            Key last = 0;
+            for (Node* node = Shared<Node*>{tx, tm.get_start()}; node;) {
+                Node entry{tx, node};
+                Key key = entry.key;
+                if (unlikely(key >= nbkeys || (count > 0 && key <= last)))
+                    return false;
+                last = key;
+                ++count;
+                node = entry.next;
+            }
+            return true;
+        });
+    }
+public:
+    /**
+     * Insert every other key, shared among the workers, and check the list order.
+    **/
+    virtual char const* init() const {
+        for (auto key = prefill.fetch_add(2, ::std::memory_order_relaxed); key < nbkeys; key = prefill.fetch_add(2, ::std::memory_order_relaxed))
+            insert_tx(key);
+        size_t count;
+        if (unlikely(!scan_tx(count)))
+            return "Violated consistency (check that committed writes in shared memory get visible to the following transactions' reads)";
+        return nullptr;
+    }
+    /**
+     * Run nbtxperwrk random lookups and updates, alternating successful insertions and removals so that the size stays constant.
+     * @param seed Randomness source
+    **/
+    virtual char const* run(Uid uid [[gnu::unused]], Seed seed) const {
+        ::std::minstd_rand engine{seed};
+        ::std::bernoulli_distribution update_dist{prob_update};
+        ::std::uniform_int_distribution<Key> key_dist{0, nbkeys - 1};
+        auto insert = (seed & 1) != 0;
+        for (size_t cntr = 0; cntr < nbtxperwrk; ++cntr) {
+            auto key = key_dist(engine);
+            if (update_dist(engine)) {
+                if (insert ? insert_tx(key) : remove_tx(key))
+                    insert = !insert;
+            } else {
+                contains_tx(key);
+            }
+        }
+        size_t count;
+        if (unlikely(!scan_tx(count)))
+            return "Violated isolation or atomicity";
+        return nullptr;
+    }
+    /**
+     * Test in which each worker removes then reinserts its own share of the keys, and the first one checks the whole list.
+     * @param uid Id of the thread to run the check
+    **/
+    virtual char const* check(Uid uid, Seed seed [[gnu::unused]]) const {
+        char const* error = nullptr;
+        barrier.sync();
+        for (Key key = uid; key < nbkeys && !error; key += nbworkers) {
+            remove_tx(key);
+            auto absent = !contains_tx(key);
+            auto inserted = insert_tx(key);
+            if (unlikely(!absent || !inserted || !contains_tx(key)))
+                error = "Violated consistency, isolation or atomicity";
+        }
+        barrier.sync();
+        if (uid == 0 && !error) {
+            size_t count;
+            if (unlikely(!scan_tx(count) || count != nbkeys))
+                return "Violated consistency";
+        }
+        return error;
+    }
+};
+
+// -------------------------------------------------------------------------- //
+
+/** Skip-list set workload class.
+**/
+class WorkloadSkipList final: public Workload {
+public:
+    /** Key class alias.
+    **/
+    using Key = uintptr_t;
+    /** Maximum number of levels.
+    **/
+    constexpr static size_t max_level = 16;
+private:
+    /** Shared skip-list node class, each allocated in its own segment with as many links as its level.
+    **/
+    class Node final {
+    private:
+        /** Dummy structure for size and alignment retrieval.
+        **/
+        struct Dummy {
+            Key    dummy0;
+            size_t dummy1;
+            void*  dummy2[];
+        };
+    public:
+        /** Get the node size for a given level.
+         * @param level Number of links of the node
+         * @return Node size (in bytes)
+        **/
+        constexpr static auto size(size_t level) noexcept {
+            return sizeof(Dummy) + level * sizeof(Node*);
+        }
+        /** Get the node alignment.
+         * @return Node alignment (in bytes)
+        **/
+        constexpr static auto align() noexcept {
+            return alignof(Dummy);
+        }
+    public:
+        Shared<Key>    key;   // Key of the element
+        Shared<size_t> level; // Number of links
+    public:
+        /** Deleted copy constructor/assignment.
+        **/
+        Node(Node const&) = delete;
+        Node& operator=(Node const&) = delete;
+        /** Binding constructor.
+         * @param tx      Associated pending transaction
+         * @param address Block base address
+        **/
+        Node(Transaction& tx, void* address): key{tx, address}, level{tx, key.after()} {}
+        /** Address of the links of the node.
+         * @return Link to the next element at level 0, followed by the upper levels
+        **/
+        Node** links() const noexcept {
+            return reinterpret_cast<Node**>(level.after());
+        }
+    };
+private:
+    size_t  nbworkers;   // Number of concurrent workers
+    size_t  nbtxperwrk;  // Number of transactions per worker
+    size_t  nbkeys;      // Keys are drawn from [0, nbkeys), half of them are in the set at any time
+    float   prob_update; // Probability of running an insertion or a removal instead of a lookup
+    Barrier barrier;     // Barrier for thread synchronization during 'check'
+    ::std::atomic<Key> mutable prefill; // Next key to insert during 'init'
+public:
+    /** Skip-list workload constructor.
+     * @param library     Transactional library to use
+     * @param nbworkers   Total number of concurrent threads (for both 'run' and 'check')
+     * @param nbtxperwrk  Number of transactions per worker
+     * @param nbkeys      Number of distinct keys, half of them are inserted at initialization
+     * @param prob_update Probability of running an insertion or a removal instead of a lookup
+    **/
+    WorkloadSkipList(TransactionalLibrary const& library, size_t nbworkers, size_t nbtxperwrk, size_t nbkeys, float prob_update): Workload{library, Node::align(), max_level * sizeof(Node*)}, nbworkers{nbworkers}, nbtxperwrk{nbtxperwrk}, nbkeys{nbkeys}, prob_update{prob_update}, barrier{static_cast<Barrier::Counter>(nbworkers)}, prefill{0} {}
+private:
+    /** Find, at every level, the link to the first element not lower than a key, in a pending transaction.
+     * @param tx    Pending transaction
+     * @param key   Key to look for
+     * @param links Set to the address of the link at each level (in the head tower or in a previous element)
+     * @return Element the link at level 0 points to ('nullptr' at the end of the list)
+    **/
+    Node* locate(Transaction& tx, Key key, Node** (&links)[max_level]) const {
+        auto tower = reinterpret_cast<Node**>(tm.get_start()); // Links of the head, then of the last element lower than key
+        Node* node = nullptr;
+        for (size_t level = max_level; level-- > 0;) {
+            node = Shared<Node*>{tx, tower + level};
+            while (node) {
+                Node entry{tx, node};
+                if (entry.key >= key)
+                    break;
+                tower = entry.links();
+                node = Shared<Node*>{tx, tower + level};
+            }
+            links[level] = tower + level;
+        }
+        return node;
+    }
+    /** Look a key up.
+     * @param key Key to look for
+     * @return Whether the key is in the set
+    **/
+    bool contains_tx(Key key) const {
+        return transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+            Node** links[max_level];
+            auto node = locate(tx, key, links);
+            return node && Node{tx, node}.key == key;
+        });
+    }
+    /** Insert a key.
+     * @param key   Key to insert
+     * @param level Number of levels of the new element
+     * @return Whether the key was not in the set
+    **/
+    bool insert_tx(Key key, size_t level) const {
+        return transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            Node** links[max_level];
+            auto node = locate(tx, key, links);
+            if (node && Node{tx, node}.key == key)
+                return false;
+            auto fresh = reinterpret_cast<Node*>(tx.alloc(Node::size(level)));
+            Node entry{tx, fresh};
+            entry.key   = key;
+            entry.level = level;
+            for (size_t i = 0; i < level; ++i) {
+                Shared<Node*>{tx, entry.links() + i} = Shared<Node*>{tx, links[i]}.read();
+                Shared<Node*>{tx, links[i]} = fresh;
+            }
+            return true;
+        });
+    }
+    /** Remove a key, freeing its element.
+     * @param key Key to remove
+     * @return Whether the key was in the set
+    **/
+    bool remove_tx(Key key) const {
+        return transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            Node** links[max_level];
+            auto node = locate(tx, key, links);
+            if (!node)
+                return false;
+            Node entry{tx, node};
+            if (entry.key != key)
+                return false;
+            size_t level = entry.level;
+            for (size_t i = 0; i < level; ++i)
+                Shared<Node*>{tx, links[i]} = Shared<Node*>{tx, entry.links() + i}.read();
+            tx.free(node);
+            return true;
+        });
+    }
+    /** Long read-only transaction, walking every level.
+     * @param count Set to the number of elements
+     * @return Whether every level is sorted, in range and only holds elements that tall
+    **/
+    bool scan_tx(size_t& count) const {
+        return transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+            auto head = reinterpret_cast<Node**>(tm.get_start());
+            for (size_t level = max_level; level-- > 0;) {
+                count = 0;
+                Key last = 0;
+                for (Node* node = Shared<Node*>{tx, head + level}; node;) {
+                    Node entry{tx, node};
+                    Key key = entry.key;
+                    size_t height = entry.level;
+                    if (unlikely(key >= nbkeys || (count > 0 && key <= last) || height <= level || height > max_level))
+                        return false;
+                    last = key;
+                    ++count;
+                    node = Shared<Node*>{tx, entry.links() + level};
+                }
+            }
+            return true;
+        });
+    }
+    /** Draw the level of a new element, each level being half as likely as the one below.
+     * @param engine Randomness source
+     * @return Level between 1 and 'max_level'
+    **/
+    static size_t draw_level(::std::minstd_rand& engine) {
+        size_t level = 1;
+        while (level < max_level && (engine() & 1))
+            ++level;
+        return level;
+    }
+public:
+    /**
+     * Insert every other key, shared among the workers, and check the levels.
+    **/
+    virtual char const* init() const {
+        auto key = prefill.fetch_add(2, ::std::memory_order_relaxed);
+        ::std::minstd_rand engine{static_cast<Seed>(key + 1)};
+        for (; key < nbkeys; key = prefill.fetch_add(2, ::std::memory_order_relaxed))
+            insert_tx(key, draw_level(engine));
+        size_t count;
+        if (unlikely(!scan_tx(count)))
+            return "Violated consistency (check that committed writes in shared memory get visible to the following transactions' reads)";
+        return nullptr;
+    }
+    /**
+     * Run nbtxperwrk random lookups and updates, alternating successful insertions and removals so that the size stays constant.
+     * @param seed Randomness source
+    **/
+    virtual char const* run(Uid uid [[gnu::unused]], Seed seed) const {
+        ::std::minstd_rand engine{seed};
+        ::std::bernoulli_distribution update_dist{prob_update};
+        ::std::uniform_int_distribution<Key> key_dist{0, nbkeys - 1};
+        auto insert = (seed & 1) != 0;
+        for (size_t cntr = 0; cntr < nbtxperwrk; ++cntr) {
+            auto key = key_dist(engine);
+            if (update_dist(engine)) {
+                if (insert ? insert_tx(key, draw_level(engine)) : remove_tx(key))
+                    insert = !insert;
+            } else {
+                contains_tx(key);
+            }
+        }
+        size_t count;
+        if (unlikely(!scan_tx(count)))
+            return "Violated isolation or atomicity";
+        return nullptr;
+    }
+    /**
+     * Test in which each worker removes then reinserts its own share of the keys, and the first one checks the whole skip list.
+     * @param uid  Id of the thread to run the check
+     * @param seed Seed to use
+    **/
+    virtual char const* check(Uid uid, Seed seed) const {
+        ::std::minstd_rand engine{seed};
+        char const* error = nullptr;
+        barrier.sync();
+        for (Key key = uid; key < nbkeys && !error; key += nbworkers) {
+            remove_tx(key);
+            auto absent = !contains_tx(key);
+            auto inserted = insert_tx(key, draw_level(engine));
+            if (unlikely(!absent || !inserted || !contains_tx(key)))
+                error = "Violated consistency, isolation or atomicity";
+        }
+        barrier.sync();
+        if (uid == 0 && !error) {
+            size_t count;
+            if (unlikely(!scan_tx(count) || count != nbkeys))
+                return "Violated consistency";
+        }
+        return error;
+    }
+};
+
+// -------------------------------------------------------------------------- //
+
+/** Red-black tree set workload class.
+**/
+class WorkloadRBTree final: public Workload {
+public:
+    /** Key and color classes alias.
+    **/
+    using Key   = uintptr_t;
+    using Color = uintptr_t;
+    constexpr static Color black = 0;
+    constexpr static Color red   = 1;
+private:
+    /** Shared tree node class, each allocated in its own segment.
+    **/
+    class Node final {
+    private:
+        /** Dummy structure for size and alignment retrieval.
+        **/
+        struct Dummy {
+            Key   dummy0;
+            Color dummy1;
+            void* dummy2[3];
+        };
+    public:
+        /** Get the node size.
+         * @return Node size (in bytes)
+        **/
+        constexpr static auto size() noexcept {
+            return sizeof(Dummy);
+        }
+        /** Get the node alignment.
+         * @return Node alignment (in bytes)
+        **/
+        constexpr static auto align() noexcept {
+            return alignof(Dummy);
+        }
+    public:
+        Shared<Key>   key;    // Key of the element
+        Shared<Color> color;  // Red or black
+        Shared<Node*> left;   // Subtree of the lower keys
+        Shared<Node*> right;  // Subtree of the greater keys
+        Shared<Node*> parent; // Parent node, 'nullptr' for the root
+    public:
+        /** Deleted copy constructor/assignment.
+        **/
+        Node(Node const&) = delete;
+        Node& operator=(Node const&) = delete;
+        /** Binding constructor.
+         * @param tx      Associated pending transaction
+         * @param address Block base address
+        **/
+        Node(Transaction& tx, void* address): key{tx, address}, color{tx, key.after()}, left{tx, color.after()}, right{tx, left.after()}, parent{tx, right.after()} {}
+    };
+    /** Tree operations in a pending transaction, absent children being black leaves.
+    **/
+    class Tree final {
+    private:
+        Transaction& tx; // Pending transaction
+        Node** root;     // Address of the root link in shared memory
+    public:
+        /** Binding constructor.
+         * @param tx   Pending transaction
+         * @param root Address of the root link
+        **/
+        Tree(Transaction& tx, void* root): tx{tx}, root{reinterpret_cast<Node**>(root)} {}
+    private:
+        Node* get_root() { return Shared<Node*>{tx, root}; }
+        void set_root(Node* node) { Shared<Node*>{tx, root} = node; }
+        Key key(Node* node) { return Node{tx, node}.key; }
+        Node* left(Node* node) { return Node{tx, node}.left; }
+        Node* right(Node* node) { return Node{tx, node}.right; }
+        Node* parent(Node* node) { return Node{tx, node}.parent; }
+        void set_left(Node* node, Node* child) { Node{tx, node}.left = child; }
+        void set_right(Node* node, Node* child) { Node{tx, node}.right = child; }
+        void set_parent(Node* node, Node* parent) { Node{tx, node}.parent = parent; }
+        bool is_red(Node* node) { return node && Node{tx, node}.color == red; }
+        void set_color(Node* node, Color color) { Node{tx, node}.color = color; }
+        /** Replace the link from the parent of a node (or the root link) to the node.
+         * @param node Node to unlink
+         * @param with Replacement, possibly 'nullptr'
+        **/
+        void transplant(Node* node, Node* with) {
+            auto up = parent(node);
+            if (!up) {
+                set_root(with);
+            } else if (node == left(up)) {
+                set_left(up, with);
+            } else {
+                set_right(up, with);
+            }
+            if (with)
+                set_parent(with, up);
+        }
+        void rotate_left(Node* node) {
+            auto pivot = right(node);
+            auto inner = left(pivot);
+            set_right(node, inner);
+            if (inner)
+                set_parent(inner, node);
+            transplant(node, pivot);
+            set_left(pivot, node);
+            set_parent(node, pivot);
+        }
+        void rotate_right(Node* node) {
+            auto pivot = left(node);
+            auto inner = right(pivot);
+            set_left(node, inner);
+            if (inner)
+                set_parent(inner, node);
+            transplant(node, pivot);
+            set_right(pivot, node);
+            set_parent(node, pivot);
+        }
+        /** Restore the invariants after inserting a red node.
+         * @param node Inserted node
+        **/
+        void insert_fixup(Node* node) {
+            Node* up;
+            while ((up = parent(node)) && is_red(up)) {
+                auto grand = parent(up); // 'up' is red, hence not the root
+                if (up == left(grand)) {
+                    auto uncle = right(grand);
+                    if (is_red(uncle)) {
+                        set_color(up, black);
+                        set_color(uncle, black);
+                        set_color(grand, red);
+                        node = grand;
+                        continue;
+                    }
+                    if (node == right(up)) {
+                        rotate_left(up);
+                        up = node;
+                    }
+                    set_color(up, black);
+                    set_color(grand, red);
+                    rotate_right(grand);
+                    break; // The subtree root is black again
+                } else {
+                    auto uncle = left(grand);
+                    if (is_red(uncle)) {
+                        set_color(up, black);
+                        set_color(uncle, black);
+                        set_color(grand, red);
+                        node = grand;
+                        continue;
+                    }
+                    if (node == left(up)) {
+                        rotate_right(up);
+                        up = node;
+                    }
+                    set_color(up, black);
+                    set_color(grand, red);
+                    rotate_left(grand);
+                    break;
+                }
+            }
+            set_color(get_root(), black);
+        }
+        /** Restore the invariants after removing a black node.
+         * @param node Node that took its place, possibly 'nullptr'
+         * @param up   Parent of 'node'
+        **/
+        void remove_fixup(Node* node, Node* up) {
+            while (node != get_root() && !is_red(node)) {
+                if (node == left(up)) { // An absent 'node' is the left child when both are absent, its sibling has a black node
+                    auto sibling = right(up);
+                    if (is_red(sibling)) {
+                        set_color(sibling, black);
+                        set_color(up, red);
+                        rotate_left(up);
+                        sibling = right(up);
+                    }
+                    if (!is_red(left(sibling)) && !is_red(right(sibling))) {
+                        set_color(sibling, red);
+                        node = up;
+                        up = parent(node);
+                        continue;
+                    }
+                    if (!is_red(right(sibling))) {
+                        set_color(left(sibling), black);
+                        set_color(sibling, red);
+                        rotate_right(sibling);
+                        sibling = right(up);
+                    }
+                    set_color(sibling, Node{tx, up}.color);
+                    set_color(up, black);
+                    set_color(right(sibling), black);
+                    rotate_left(up);
+                } else {
+                    auto sibling = left(up);
+                    if (is_red(sibling)) {
+                        set_color(sibling, black);
+                        set_color(up, red);
+                        rotate_right(up);
+                        sibling = left(up);
+                    }
+                    if (!is_red(left(sibling)) && !is_red(right(sibling))) {
+                        set_color(sibling, red);
+                        node = up;
+                        up = parent(node);
+                        continue;
+                    }
+                    if (!is_red(left(sibling))) {
+                        set_color(right(sibling), black);
+                        set_color(sibling, red);
+                        rotate_left(sibling);
+                        sibling = left(up);
+                    }
+                    set_color(sibling, Node{tx, up}.color);
+                    set_color(up, black);
+                    set_color(left(sibling), black);
+                    rotate_right(up);
+                }
+                node = get_root();
+            }
+            if (node)
+                set_color(node, black);
+        }
+    public:
+        /** Look a key up.
+         * @param needle Key to look for
+         * @return Node holding the key, 'nullptr' if none
+        **/
+        Node* find(Key needle) {
+            auto node = get_root();
+            while (node) {
+                auto current = key(node);
+                if (needle == current)
+                    break;
+                node = needle < current ? left(node) : right(node);
+            }
+            return node;
+        }
+        /** Insert a key.
+         * @param needle Key to insert
+         * @return Whether the key was not in the tree
+        **/
+        bool insert(Key needle) {
+            Node* up = nullptr;
+            for (auto node = get_root(); node;) {
+                auto current = key(node);
+                if (needle == current)
+                    return false;
+                up = node;
+                node = needle < current ? left(node) : right(node);
+            }
+            auto fresh = reinterpret_cast<Node*>(tx.alloc(Node::size()));
+            Node entry{tx, fresh};
+            entry.key    = needle;
+            entry.color  = red;
+            entry.parent = up;
+            if (!up) {
+                set_root(fresh);
+            } else if (needle < key(up)) {
+                set_left(up, fresh);
+            } else {
+                set_right(up, fresh);
+            }
+            insert_fixup(fresh);
+            return true;
+        }
+        /** Remove a key, freeing its node.
+         * @param needle Key to remove
+         * @return Whether the key was in the tree
+        **/
+        bool remove(Key needle) {
+            auto node = find(needle);
+            if (!node)
+                return false;
+            Node entry{tx, node};
+            Color removed = entry.color; // Color of the node leaving its position
+            Node* child;
+            Node* up;
+            if (!entry.left.read()) {
+                child = entry.right;
+                up = entry.parent;
+                transplant(node, child);
+            } else if (!entry.right.read()) {
+                child = entry.left;
+                up = entry.parent;
+                transplant(node, child);
+            } else { // The successor takes the place and the color of the node
+                auto next = entry.right.read();
+                for (Node* lower; (lower = left(next));)
+                    next = lower;
+                removed = Node{tx, next}.color;
+                child = right(next);
+                if (parent(next) == node) {
+                    up = next;
+                } else {
+                    up = parent(next);
+                    transplant(next, child);
+                    set_right(next, entry.right);
+                    set_parent(right(next), next);
+                }
+                transplant(node, next);
+                set_left(next, entry.left);
+                set_parent(left(next), next);
+                set_color(next, entry.color);
+            }
+            if (removed == black)
+                remove_fixup(child, up);
+            tx.free(node);
+            return true;
+        }
+        /** Check the subtree invariants.
+         * @param node   Subtree root
+         * @param up     Expected parent
+         * @param lower  Keys must be greater or equal
+         * @param upper  Keys must be lower
+         * @param count  Incremented by the number of nodes
+         * @return Black height of the subtree, -1 if an invariant does not hold
+        **/
+        long validate(Node* node, Node* up, Key lower, Key upper, size_t& count) {
+            if (!node)
+                return 1;
+            Node entry{tx, node};
+            Key current = entry.key;
+            Color color = entry.color;
+            if (unlikely(current < lower || current >= upper || entry.parent.read() != up || (color != red && color != black)))
+                return -1;
+            if (unlikely(color == red && (is_red(entry.left) || is_red(entry.right))))
+                return -1;
+            ++count;
+            auto height = validate(entry.left, node, lower, current, count);
+            if (unlikely(height < 0 || validate(entry.right, node, current + 1, upper, count) != height))
+                return -1;
+            return height + (color == black);
+        }
+        /** Check the whole tree invariants.
+         * @param upper Keys must be lower
+         * @param count Set to the number of nodes
+         * @return Whether the tree is a valid red-black tree
+        **/
+        bool validate(Key upper, size_t& count) {
+            count = 0;
+            auto top = get_root();
+            return !is_red(top) && validate(top, nullptr, 0, upper, count) >= 0;
+        }
+    };
+private:
+    size_t  nbworkers;   // Number of concurrent workers
+    size_t  nbtxperwrk;  // Number of transactions per worker
+    size_t  nbkeys;      // Keys are drawn from [0, nbkeys)
+    float   prob_lookup; // Relative weight of lookups
+    float   prob_insert; // Relative weight of insertions
+    float   prob_remove; // Relative weight of removals
+    Barrier barrier;     // Barrier for thread synchronization during 'check'
+    ::std::atomic<Key> mutable prefill; // Next key to insert during 'init'
+public:
+    /** Red-black tree workload constructor.
+     * @param library     Transactional library to use
+     * @param nbworkers   Total number of concurrent threads (for both 'run' and 'check')
+     * @param nbtxperwrk  Number of transactions per worker
+     * @param nbkeys      Number of distinct keys, half of them are inserted at initialization
+     * @param prob_lookup Relative weight of lookups
+     * @param prob_insert Relative weight of insertions
+     * @param prob_remove Relative weight of removals
+    **/
+    WorkloadRBTree(TransactionalLibrary const& library, size_t nbworkers, size_t nbtxperwrk, size_t nbkeys, float prob_lookup, float prob_insert, float prob_remove): Workload{library, Node::align(), sizeof(Node*)}, nbworkers{nbworkers}, nbtxperwrk{nbtxperwrk}, nbkeys{nbkeys}, prob_lookup{prob_lookup}, prob_insert{prob_insert}, prob_remove{prob_remove}, barrier{static_cast<Barrier::Counter>(nbworkers)}, prefill{0} {}
+private:
+    bool contains_tx(Key key) const {
+        return transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+            return Tree{tx, tm.get_start()}.find(key) != nullptr;
+        });
+    }
+    bool insert_tx(Key key) const {
+        return transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            return Tree{tx, tm.get_start()}.insert(key);
+        });
+    }
+    bool remove_tx(Key key) const {
+        return transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            return Tree{tx, tm.get_start()}.remove(key);
+        });
+    }
+    /** Long read-only transaction, checking the whole tree.
+     * @param count Set to the number of nodes
+     * @return Whether the tree is a valid red-black tree
+    **/
+    bool validate_tx(size_t& count) const {
+        return transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+            return Tree{tx, tm.get_start()}.validate(nbkeys, count);
+        });
+    }
+public:
+    /**
+     * Insert every other key, shared among the workers, and check the tree.
+    **/
+    virtual char const* init() const {
+        for (auto key = prefill.fetch_add(2, ::std::memory_order_relaxed); key < nbkeys; key = prefill.fetch_add(2, ::std::memory_order_relaxed))
+            insert_tx(key);
+        size_t count;
+        if (unlikely(!validate_tx(count)))
+            return "Violated consistency (check that committed writes in shared memory get visible to the following transactions' reads)";
+        return nullptr;
+    }
+    /**
+     * Run nbtxperwrk random lookups, insertions and removals, then check the tree.
+     * @param seed Randomness source
+    **/
+    virtual char const* run(Uid uid [[gnu::unused]], Seed seed) const {
+        ::std::minstd_rand engine{seed};
+        ::std::discrete_distribution<int> op_dist{prob_lookup, prob_insert, prob_remove};
+        ::std::uniform_int_distribution<Key> key_dist{0, nbkeys - 1};
+        for (size_t cntr = 0; cntr < nbtxperwrk; ++cntr) {
+            auto key = key_dist(engine);
+            switch (op_dist(engine)) {
+            case 0:
+                contains_tx(key);
+                break;
+            case 1:
+                insert_tx(key);
+                break;
+            default:
+                remove_tx(key);
+            }
+        }
+        size_t count;
+        if (unlikely(!validate_tx(count)))
+            return "Violated isolation or atomicity";
+        return nullptr;
+    }
+    /**
+     * Test in which each worker removes then reinserts its own share of the keys, and the first one checks the whole tree.
+     * @param uid Id of the thread to run the check
+    **/
+    virtual char const* check(Uid uid, Seed seed [[gnu::unused]]) const {
+        char const* error = nullptr;
+        barrier.sync();
+        for (Key key = uid; key < nbkeys && !error; key += nbworkers) {
+            remove_tx(key);
+            auto absent = !contains_tx(key);
+            auto inserted = insert_tx(key);
+            if (unlikely(!absent || !inserted || !contains_tx(key)))
+                error = "Violated consistency, isolation or atomicity";
+        }
+        barrier.sync();
+        if (uid == 0 && !error) {
+            size_t count;
+            if (unlikely(!validate_tx(count) || count != nbkeys))
+                return "Violated consistency";
+        }
+        return error;
+    }
+};
+
+// -------------------------------------------------------------------------- //
+
+/** FIFO queue workload class, every transaction writes the head or the tail.
+**/
+class WorkloadQueue final: public Workload {
+public:
+    /** Element value class alias.
+    **/
+    using Value = uintptr_t;
+private:
+    /** Shared queue element class, each allocated in its own segment.
+    **/
+    class Node final {
+    private:
+        /** Dummy structure for size and alignment retrieval.
+        **/
+        struct Dummy {
+            Value dummy0;
+            void* dummy1;
+        };
+    public:
+        /** Get the node size.
+         * @return Node size (in bytes)
+        **/
+        constexpr static auto size() noexcept {
+            return sizeof(Dummy);
+        }
+        /** Get the node alignment.
+         * @return Node alignment (in bytes)
+        **/
+        constexpr static auto align() noexcept {
+            return alignof(Dummy);
+        }
+    public:
+        Shared<Value> value; // Producer and sequence number of the element
+        Shared<Node*> next;  // Next element, enqueued later
+    public:
+        /** Deleted copy constructor/assignment.
+        **/
+        Node(Node const&) = delete;
+        Node& operator=(Node const&) = delete;
+        /** Binding constructor.
+         * @param tx      Associated pending transaction
+         * @param address Block base address
+        **/
+        Node(Transaction& tx, void* address): value{tx, address}, next{tx, value.after()} {}
+    };
+    /** Queue ends, at the start of the shared memory region.
+    **/
+    class Ends final {
+    public:
+        Shared<Node*> head; // Oldest element, 'nullptr' if empty
+        Shared<Node*> tail; // Newest element, 'nullptr' if empty
+    public:
+        /** Deleted copy constructor/assignment.
+        **/
+        Ends(Ends const&) = delete;
+        Ends& operator=(Ends const&) = delete;
+        /** Binding constructor.
+         * @param tx      Associated pending transaction
+         * @param address Block base address
+        **/
+        Ends(Transaction& tx, void* address): head{tx, address}, tail{tx, head.after()} {}
+    };
+    /** Flag of the elements enqueued during 'check', telling them apart from the ones of 'run'.
+    **/
+    constexpr static Value check_flag = Value{1} << (8 * sizeof(Value) - 1);
+private:
+    size_t  nbworkers;   // Number of concurrent workers
+    size_t  nbtxperwrk;  // Number of enqueue transactions per producer
+    size_t  nbproducers; // Workers [0, nbproducers) enqueue, the others dequeue (a single worker does both)
+    size_t  batch;       // Number of elements enqueued or dequeued per transaction
+    size_t  nbcheck;     // Number of elements enqueued per producer during 'check'
+    Barrier barrier;     // Barrier for thread synchronization during 'check'
+    ::std::atomic<size_t> mutable dequeued;       // Elements dequeued by all the runs so far
+    ::std::atomic<size_t> mutable check_dequeued; // Elements dequeued during 'check'
+    ::std::vector<size_t> mutable runs;           // Runs done so far, by worker
+    ::std::vector<size_t> mutable sequences;      // Next sequence number, by producer
+    ::std::vector<::std::atomic<bool>> mutable seen; // Elements of 'check' dequeued, by value
+public:
+    /** Queue workload constructor.
+     * @param library     Transactional library to use
+     * @param nbworkers   Total number of concurrent threads (for both 'run' and 'check')
+     * @param nbtxperwrk  Number of enqueue transactions per producer
+     * @param nbproducers Number of producers, clamped so that there is at least one producer and one consumer
+     * @param batch       Number of elements enqueued or dequeued per transaction
+    **/
+    WorkloadQueue(TransactionalLibrary const& library, size_t nbworkers, size_t nbtxperwrk, size_t nbproducers, size_t batch): Workload{library, Node::align(), 2 * sizeof(Node*)}, nbworkers{nbworkers}, nbtxperwrk{nbtxperwrk}, nbproducers{nbworkers > 1 ? ::std::min(::std::max(nbproducers, size_t{1}), nbworkers - 1) : 1}, batch{::std::max(batch, size_t{1})}, nbcheck{256 * this->batch}, barrier{static_cast<Barrier::Counter>(nbworkers)}, dequeued{0}, check_dequeued{0}, runs(nbworkers, 0), sequences(nbworkers, 0), seen(nbworkers * nbcheck) {}
+private:
+    /** Enqueue consecutive elements of a producer.
+     * @param uid      Producer
+     * @param sequence First sequence number, advanced past the enqueued elements
+     * @param count    Number of elements
+     * @param flag     Flag to set in the values
+    **/
+    void enqueue_tx(Uid uid, size_t& sequence, size_t count, Value flag) const {
+        transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            Ends ends{tx, tm.get_start()};
+            Node* last = ends.tail;
+            for (size_t i = 0; i < count; ++i) {
+                auto fresh = reinterpret_cast<Node*>(tx.alloc(Node::size()));
+                Node entry{tx, fresh};
+                entry.value = flag | ((sequence + i) * nbworkers + uid);
+                entry.next  = nullptr;
+                if (last) {
+                    Node{tx, last}.next = fresh;
+                } else {
+                    ends.head = fresh;
+                }
+                last = fresh;
+            }
+            ends.tail = last;
+        });
+        sequence += count;
+    }
+    /** Dequeue up to some elements, freeing them.
+     * @param count  Maximum number of elements
+     * @param values Set to the dequeued values, oldest first
+     * @return Number of dequeued elements
+    **/
+    size_t dequeue_tx(size_t count, ::std::vector<Value>& values) const {
+        return transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            values.clear();
+            Ends ends{tx, tm.get_start()};
+            Node* node = ends.head;
+            while (node && values.size() < count) {
+                Node entry{tx, node};
+                values.push_back(entry.value);
+                Node* next = entry.next;
+                tx.free(node);
+                node = next;
+            }
+            if (!values.empty()) {
+                ends.head = node;
+                if (!node)
+                    ends.tail = nullptr;
+            }
+            return values.size();
+        });
+    }
+    /** Check that the queue is empty.
+     * @return Whether both ends are 'nullptr'
+    **/
+    bool empty_tx() const {
+        return transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+            Ends ends{tx, tm.get_start()};
+            return !ends.head && !ends.tail;
+        });
+    }
+    /** Enqueue and/or dequeue as a worker of the given role, until every element up to some target got dequeued.
+     * @param uid      Id of the worker, producer if lower than 'nbproducers'
+     * @param sequence First sequence number, advanced past the enqueued elements
+     * @param quota    Number of elements to enqueue if producer
+     * @param flag     Flag to set in the enqueued values, and expected in the dequeued ones
+     * @param counter  Counter of the dequeued elements
+     * @param target   Value of the counter once every element is dequeued
+     * @param marks    Dequeued flag of each value, 'nullptr' for none
+     * @return Constant null-terminated error message, 'nullptr' for none
+    **/
+    char const* transfer(Uid uid, size_t& sequence, size_t quota, Value flag, ::std::atomic<size_t>& counter, size_t target, ::std::atomic<bool>* marks) const {
+        auto const producer = uid < nbproducers;
+        auto const consumer = uid >= nbproducers || nbworkers == 1;
+        ::std::vector<Value> values;
+        values.reserve(batch);
+        ::std::vector<size_t> last(nbworkers, 0); // Last sequence number + 1 dequeued, by producer
+        size_t produced = 0;
+        while (true) {
+            if (producer && produced < quota) {
+                auto count = ::std::min(batch, quota - produced);
+                enqueue_tx(uid, sequence, count, flag);
+                produced += count;
+            } else if (!consumer) {
+                return nullptr;
+            }
+            if (!consumer)
+                continue;
+            if (dequeue_tx(batch, values) == 0) {
+                if (counter.load(::std::memory_order_relaxed) >= target)
+                    return nullptr;
+                if (!producer || produced >= quota)
+                    short_pause();
+                continue;
+            }
+            for (auto value: values) {
+                if (unlikely((value & check_flag) != flag))
+                    return "Violated isolation or atomicity (unexpected element dequeued)";
+                auto index = value & ~check_flag;
+                auto from = index % nbworkers;
+                auto seqnext = index / nbworkers + 1;
+                if (unlikely(from >= nbproducers || seqnext <= last[from]))
+                    return "Violated isolation or atomicity (element dequeued twice or out of order)";
+                last[from] = seqnext;
+                if (marks && unlikely(marks[index].exchange(true, ::std::memory_order_relaxed)))
+                    return "Violated isolation or atomicity (element dequeued twice)";
+            }
+            if (counter.fetch_add(values.size(), ::std::memory_order_relaxed) + values.size() >= target)
+                return nullptr;
+        }
+    }
+public:
+    /**
+     * Empty the queue.
+    **/
+    virtual char const* init() const {
+        if (unlikely(!empty_tx()))
+            return "Violated consistency (check that committed writes in shared memory get visible to the following transactions' reads)";
+        return nullptr;
+    }
+    /**
+     * Producers enqueue nbtxperwrk batches, consumers dequeue until every element of the run got out in per-producer FIFO order.
+     * A lost element keeps the consumers waiting, and is caught by the time limit; a duplicated one is reported by 'check'.
+     * @param uid Id of the worker
+    **/
+    virtual char const* run(Uid uid, Seed seed [[gnu::unused]]) const {
+        auto target = ++runs[uid] * nbproducers * nbtxperwrk * batch;
+        return transfer(uid, sequences[uid], nbtxperwrk * batch, 0, dequeued, target, nullptr);
+    }
+    /**
+     * Check that the runs left the queue empty with every element dequeued once, then move nbcheck elements per producer through it, each of which must come out exactly once.
+     * @param uid Id of the thread to run the check
+    **/
+    virtual char const* check(Uid uid, Seed seed [[gnu::unused]]) const {
+        char const* error = nullptr;
+        barrier.sync();
+        if (uid == 0) {
+            if (unlikely(!empty_tx() || dequeued.load() != runs[0] * nbproducers * nbtxperwrk * batch))
+                error = "Violated consistency (elements lost or dequeued twice)";
+            check_dequeued.store(0);
+            for (auto& mark: seen)
+                mark.store(false, ::std::memory_order_relaxed);
+        }
+        barrier.sync();
+        { // Every worker takes part, the consumers would wait for the elements of a missing producer
+            size_t sequence = 0;
+            auto res = transfer(uid, sequence, nbcheck, check_flag, check_dequeued, nbproducers * nbcheck, seen.data());
+            if (!error)
+                error = res;
+        }
+        barrier.sync();
+        if (uid == 0 && !error) {
+            for (size_t from = 0; from < nbproducers; ++from) {
+                for (size_t sequence = 0; sequence < nbcheck; ++sequence) {
+                    if (unlikely(!seen[sequence * nbworkers + from].load(::std::memory_order_relaxed)))
+                        return "Violated consistency (element lost)";
+                }
+            }
+            if (unlikely(!empty_tx()))
+                return "Violated consistency";
+        }
+        return error;
+    }
+    /**
+     * One enqueue and one dequeue per element.
+    **/
+    virtual size_t operations() const {
+        return 2 * nbproducers * nbtxperwrk * batch;
+    }
+};
+
+// -------------------------------------------------------------------------- //
+
+/** YCSB-style key-value workload class, over a table of fixed-size records.
+**/
+class WorkloadYCSB final: public Workload {
+public:
+    /** Field value class alias.
+    **/
+    using Value = uintptr_t;
+    /** Key popularity.
+    **/
+    enum class Distribution {
+        uniform, // Every acknowledged key alike
+        zipfian, // Scrambled Zipfian over the initial records
+        latest   // Zipfian over the most recently inserted records first
+    };
+    /** Operation mix, as relative weights.
+    **/
+    struct Mix {
+        float read;   // Read a whole record
+        float update; // Write one field
+        float rmw;    // Read a whole record, then write one field
+        float scan;   // Read consecutive records
+        float insert; // Append a record
+        Distribution distribution; // Key popularity
+    };
+    /** Get one of the YCSB core workload mixes.
+     * @param letter Workload letter, from 'a' to 'f'
+     * @return Corresponding mix, workload F for an unknown letter
+    **/
+    static Mix preset(char letter) noexcept {
+        switch (letter) {
+        case 'a': return {0.50f, 0.50f, 0.00f, 0.00f, 0.00f, Distribution::zipfian}; // Update heavy
+        case 'b': return {0.95f, 0.05f, 0.00f, 0.00f, 0.00f, Distribution::zipfian}; // Read mostly
+        case 'c': return {1.00f, 0.00f, 0.00f, 0.00f, 0.00f, Distribution::zipfian}; // Read only
+        case 'd': return {0.95f, 0.00f, 0.00f, 0.00f, 0.05f, Distribution::latest};  // Read latest
+        case 'e': return {0.00f, 0.00f, 0.00f, 0.95f, 0.05f, Distribution::zipfian}; // Short ranges
+        default:  return {0.50f, 0.00f, 0.50f, 0.00f, 0.00f, Distribution::zipfian}; // Read-modify-write
+        }
+    }
+    /** Get the name of a key distribution.
+     * @param distribution Key distribution
+     * @return Constant null-terminated name
+    **/
+    static char const* name(Distribution distribution) noexcept {
+        switch (distribution) {
+        case Distribution::uniform: return "uniform";
+        case Distribution::zipfian: return "zipfian";
+        default:                    return "latest";
+        }
+    }
+private:
+    /** Shared table class, at the start of the shared memory region.
+    **/
+    class Table final {
+    private:
+        /** Dummy structure for size and alignment retrieval.
+        **/
+        struct Dummy {
+            size_t dummy0;
+            Value  dummy1[];
+        };
+    public:
+        /** Get the table size for a given number of words of records.
+         * @param nbwords Total number of words of the records
+         * @return Table size (in bytes)
+        **/
+        constexpr static auto size(size_t nbwords) noexcept {
+            return sizeof(Dummy) + nbwords * sizeof(Value);
+        }
+        /** Get the table alignment.
+         * @return Table alignment (in bytes)
+        **/
+        constexpr static auto align() noexcept {
+            return alignof(Dummy);
+        }
+    public:
+        Shared<size_t>  count;   // Number of records, those of keys [0, count)
+        Shared<Value[]> records; // Fields then sum of the fields of each record, by key
+    public:
+        /** Deleted copy constructor/assignment.
+        **/
+        Table(Table const&) = delete;
+        Table& operator=(Table const&) = delete;
+        /** Binding constructor.
+         * @param tx      Associated pending transaction
+         * @param address Block base address
+        **/
+        Table(Transaction& tx, void* address): count{tx, address}, records{tx, count.after()} {}
+    };
+    /** Odd multiplier spreading the Zipfian ranks over the keys, a bijection unless the number of records is one of its multiples.
+    **/
+    constexpr static size_t scramble = 2654435761ul;
+private:
+    size_t  nbworkers;  // Number of concurrent workers
+    size_t  nbtxperwrk; // Number of transactions per worker
+    size_t  nbrecords;  // Initial number of records
+    size_t  capacity;   // Maximum number of records, inserts beyond are dropped
+    size_t  nbfields;   // Number of fields per record
+    size_t  scanlen;    // Maximum number of records per scan
+    Mix     mix;        // Operation mix and key popularity
+    ZipfianDistribution zipf; // Zipfian ranks over the initial records
+    Barrier barrier;    // Barrier for thread synchronization during 'check'
+    ::std::atomic<size_t> mutable acknowledged; // Number of records known to be committed, keys are drawn below
+public:
+    /** YCSB workload constructor.
+     * @param library    Transactional library to use
+     * @param nbworkers  Total number of concurrent threads (for both 'run' and 'check')
+     * @param nbtxperwrk Number of transactions per worker
+     * @param nbrecords  Initial number of records
+     * @param nbfields   Number of fields per record
+     * @param scanlen    Maximum number of records per scan
+     * @param mix        Operation mix and key popularity
+     * @param theta      Zipfian skew in [0, 1)
+    **/
+    WorkloadYCSB(TransactionalLibrary const& library, size_t nbworkers, size_t nbtxperwrk, size_t nbrecords, size_t nbfields, size_t scanlen, Mix const& mix, double theta): Workload{library, Table::align(), Table::size((nbrecords + (mix.insert > 0 ? nbworkers * nbtxperwrk : 0)) * (nbfields + 1))}, nbworkers{nbworkers}, nbtxperwrk{nbtxperwrk}, nbrecords{nbrecords}, capacity{nbrecords + (mix.insert > 0 ? nbworkers * nbtxperwrk : 0)}, nbfields{nbfields}, scanlen{scanlen}, mix(mix), zipf{nbrecords, theta}, barrier{static_cast<Barrier::Counter>(nbworkers)}, acknowledged{nbrecords} {}
+private:
+    /** Address of a record.
+     * @param table Bound table
+     * @param key   Key of the record
+     * @return Address of its first field
+    **/
+    Value* record(Table const& table, size_t key) const noexcept {
+        return table.records.get() + key * (nbfields + 1);
+    }
+    /** Check a private copy of a record, each field must be its key modulo the capacity and the last word their sum.
+     * The records start zeroed in shared memory and stand for their initial value (every field the key) until first written.
+     * @param words    Fields then sum, a zeroed record is replaced with its initial value
+     * @param key      Key of the record
+     * @param pristine Set to whether the record was still zeroed
+     * @return Whether the record is consistent
+    **/
+    bool load(Value* words, size_t key, bool& pristine) const noexcept {
+        pristine = key != 0 && words[nbfields] == 0;
+        if (pristine) {
+            for (size_t i = 0; i < nbfields; ++i) {
+                if (unlikely(words[i] != 0))
+                    return false;
+                words[i] = key;
+            }
+            words[nbfields] = key * nbfields;
+            return true;
+        }
+        Value sum = 0;
+        for (size_t i = 0; i < nbfields; ++i) {
+            if (unlikely(words[i] % capacity != key))
+                return false;
+            sum += words[i];
+        }
+        return sum == words[nbfields];
+    }
+    /** Draw a key.
+     * @param engine Randomness source
+     * @param limit  Number of acknowledged records
+     * @return Key in [0, limit)
+    **/
+    template<class Engine> size_t draw(Engine& engine, size_t limit) const {
+        switch (mix.distribution) {
+        case Distribution::uniform:
+            return ::std::uniform_int_distribution<size_t>{0, limit - 1}(engine);
+        case Distribution::zipfian:
+            return zipf(engine) * scramble % nbrecords;
+        default:
+            return limit - 1 - ::std::min(zipf(engine), limit - 1);
+        }
+    }
+    /** Read a whole record.
+     * @param key   Key of the record
+     * @param words Private buffer of nbfields + 1 words
+     * @return Whether the record is consistent
+    **/
+    bool read_tx(size_t key, Value* words) const {
+        return transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+            Table table{tx, tm.get_start()};
+            tx.read(record(table, key), (nbfields + 1) * sizeof(Value), words);
+            bool pristine;
+            return load(words, key, pristine);
+        });
+    }
+    /** Write back one modified field of a record, and its sum.
+     * @param tx       Pending transaction
+     * @param table    Bound table
+     * @param key      Key of the record
+     * @param field    Modified field
+     * @param words    Private copy of the record, already updated
+     * @param pristine Whether the record was still zeroed, then written as a whole
+    **/
+    void store(Transaction& tx, Table const& table, size_t key, size_t field, Value const* words, bool pristine) const {
+        if (pristine) {
+            tx.write(words, (nbfields + 1) * sizeof(Value), record(table, key));
+            return;
+        }
+        auto base = key * (nbfields + 1);
+        table.records[base + field] = words[field];
+        table.records[base + nbfields] = words[nbfields];
+    }
+    /** Overwrite one field of a record.
+     * @param key   Key of the record
+     * @param field Field to write
+     * @param stamp New version of the field
+     * @param words Private buffer of nbfields + 1 words
+     * @return Whether the record was consistent
+    **/
+    bool update_tx(size_t key, size_t field, Value stamp, Value* words) const {
+        return transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            Table table{tx, tm.get_start()};
+            auto base = key * (nbfields + 1);
+            words[field] = table.records[base + field];
+            words[nbfields] = table.records[base + nbfields];
+            auto pristine = key != 0 && words[nbfields] == 0;
+            if (pristine) { // The whole record gets written
+                tx.read(record(table, key), (nbfields + 1) * sizeof(Value), words);
+                if (unlikely(!load(words, key, pristine)))
+                    return false;
+            }
+            Value fresh = key + capacity * stamp;
+            words[nbfields] += fresh - words[field];
+            words[field] = fresh;
+            store(tx, table, key, field, words, pristine);
+            return true;
+        });
+    }
+    /** Read a whole record, then bump the version of one of its fields.
+     * @param key   Key of the record
+     * @param field Field to write
+     * @param words Private buffer of nbfields + 1 words
+     * @return Whether the record was consistent
+    **/
+    bool rmw_tx(size_t key, size_t field, Value* words) const {
+        return transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            Table table{tx, tm.get_start()};
+            tx.read(record(table, key), (nbfields + 1) * sizeof(Value), words);
+            bool pristine;
+            if (unlikely(!load(words, key, pristine)))
+                return false;
+            words[field] += capacity;
+            words[nbfields] += capacity;
+            store(tx, table, key, field, words, pristine);
+            return true;
+        });
+    }
+    /** Read consecutive records.
+     * @param key    Key of the first record
+     * @param length Number of records, truncated at the last acknowledged one
+     * @param limit  Number of acknowledged records
+     * @param words  Private buffer of nbfields + 1 words
+     * @return Whether every record was consistent
+    **/
+    bool scan_tx(size_t key, size_t length, size_t limit, Value* words) const {
+        return transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+            Table table{tx, tm.get_start()};
+            for (auto end = ::std::min(key + length, limit); key < end; ++key) {
+                tx.read(record(table, key), (nbfields + 1) * sizeof(Value), words);
+                bool pristine;
+                if (unlikely(!load(words, key, pristine)))
+                    return false;
+            }
+            return true;
+        });
+    }
+    /** Append a record, then acknowledge it.
+     * @param words Private buffer of nbfields + 1 words
+    **/
+    void insert_tx(Value* words) const {
+        auto key = transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            Table table{tx, tm.get_start()};
+            size_t key = table.count;
+            if (key >= capacity)
+                return key;
+            ::std::fill(words, words + nbfields, key);
+            words[nbfields] = key * nbfields;
+            tx.write(words, (nbfields + 1) * sizeof(Value), record(table, key));
+            table.count = key + 1;
+            return key;
+        });
+        if (key >= capacity)
+            return;
+        auto known = acknowledged.load(::std::memory_order_relaxed);
+        while (known < key + 1 && !acknowledged.compare_exchange_weak(known, key + 1, ::std::memory_order_relaxed));
+    }
+    /** Long read-only transaction, checking the whole table.
+     * @param count Set to the number of records
+     * @return Whether every record is consistent
+    **/
+    bool validate_tx(size_t& count) const {
+        return transactional(tm, Transaction::Mode::read_only, [&](Transaction& tx) {
+            ::std::vector<Value> words(nbfields + 1);
+            Table table{tx, tm.get_start()};
+            count = table.count;
+            for (size_t key = 0; key < count; ++key) {
+                tx.read(record(table, key), (nbfields + 1) * sizeof(Value), words.data());
+                bool pristine;
+                if (unlikely(!load(words.data(), key, pristine)))
+                    return false;
+            }
+            return true;
+        });
+    }
+public:
+    /**
+     * Set the number of records, their zeroed memory standing for their initial value, and check the table.
+    **/
+    virtual char const* init() const {
+        ::std::vector<Value> words(nbfields + 1);
+        transactional(tm, Transaction::Mode::read_write, [&](Transaction& tx) {
+            Table{tx, tm.get_start()}.count = nbrecords;
+        });
+        if (unlikely(!read_tx(nbrecords - 1, words.data())))
+            return "Violated consistency (check that committed writes in shared memory get visible to the following transactions' reads)";
+        return nullptr;
+    }
+    /**
+     * Run nbtxperwrk operations drawn from the mix, every record read must be consistent.
+     * @param seed Randomness source
+    **/
+    virtual char const* run(Uid uid [[gnu::unused]], Seed seed) const {
+        ::std::minstd_rand engine{seed};
+        ::std::discrete_distribution<int> op_dist{mix.read, mix.update, mix.rmw, mix.scan, mix.insert};
+        ::std::uniform_int_distribution<size_t> field_dist{0, nbfields - 1};
+        ::std::uniform_int_distribution<size_t> length_dist{1, scanlen};
+        ::std::vector<Value> words(nbfields + 1);
+        for (size_t cntr = 0; cntr < nbtxperwrk; ++cntr) {
+            auto limit = acknowledged.load(::std::memory_order_relaxed);
+            auto key = draw(engine, limit);
+            auto ok = true;
+            switch (op_dist(engine)) {
+            case 0:
+                ok = read_tx(key, words.data());
+                break;
+            case 1:
+                ok = update_tx(key, field_dist(engine), engine(), words.data());
+                break;
+            case 2:
+                ok = rmw_tx(key, field_dist(engine), words.data());
+                break;
+            case 3:
+                ok = scan_tx(key, length_dist(engine), limit, words.data());
+                break;
+            default:
+                insert_tx(words.data());
+            }
+            if (unlikely(!ok))
+                return "Violated isolation or atomicity";
+        }
+        return nullptr;
+    }
+    /**
+     * Test in which each worker updates then reads its own share of the records, and the first one checks the whole table.
+     * @param uid Id of the thread to run the check
+    **/
+    virtual char const* check(Uid uid, Seed seed [[gnu::unused]]) const {
+        char const* error = nullptr;
+        ::std::vector<Value> words(nbfields + 1);
+        barrier.sync();
+        auto limit = acknowledged.load();
+        for (size_t key = uid; key < limit && !error; key += nbworkers) {
+            if (unlikely(!rmw_tx(key, key % nbfields, words.data()) || !read_tx(key, words.data())))
+                error = "Violated consistency, isolation or atomicity";
+        }
+        barrier.sync();
+        if (uid == 0 && !error) {
+            size_t count;
+            if (unlikely(!validate_tx(count) || count != limit))
+                return "Violated consistency";
+        }
+        return error;
+    }
+    /**
+     * One key-value operation per transaction.
+    **/
+    virtual size_t operations() const {
+        return nbworkers * nbtxperwrk;
+    }
+};
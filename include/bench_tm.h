@@ -0,0 +1,37 @@
+#ifndef BENCH_TM_H
+#define BENCH_TM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tm.h>
+#include <tm_ext.h>
+
+// Default configuration, overridable per benchmark on the command line
+#define BENCH_TX_PER_THREAD 100000
+#define BENCH_ACCOUNTS 1024
+#define BENCH_ALIGN 8
+
+// Benchmark entry point, argv[0] is the benchmark name
+typedef int (*bench_func_t)(int argc, char** argv);
+
+// Helpers shared by the benchmarks
+uint64_t bench_now_ns(void);
+unsigned int bench_default_threads(void);
+unsigned long bench_arg(int argc, char** argv, int index, unsigned long fallback);
+
+// Benchmarks
+int bench_options(int argc, char** argv);
+int bench_read(int argc, char** argv);
+int bench_access(int argc, char** argv);
+int bench_restart(int argc, char** argv);
+int bench_dict(int argc, char** argv);
+int bench_commit(int argc, char** argv);
+int bench_arena(int argc, char** argv);
+int bench_growth(int argc, char** argv);
+int bench_alloc(int argc, char** argv);
+int bench_free(int argc, char** argv);
+int bench_lock(int argc, char** argv);
+int bench_validate(int argc, char** argv);
+int bench_cold(int argc, char** argv);
+
+#endif // BENCH_TM_H
@@ -3,33 +3,74 @@
 #include <stdlib.h> /* malloc/calloc */
 #include <stdint.h> /* uint32_t */
 #include <string.h> /* memcpy/memcmp */
-#include <xmmintrin.h>
+#include <stdbool.h>
 
 typedef int (*enumFunc)(void *key, int count, void* *value, void *user);
 
 #define HASHDICT_VALUE_TYPE void* // we want to hold void*
-#define KEY_LENGTH_TYPE uint8_t
 
-struct keynode {
-	struct keynode *next;
-	unsigned char *key;
-	KEY_LENGTH_TYPE len;
-	HASHDICT_VALUE_TYPE value;
+#define DIC_GROUP 16 // control bytes probed at once, one SSE2 register
+#define DIC_SMALL 16 // entries kept inline, searched linearly, before the table is built
+#define DIC_GROWTH_FACTOR 2     // default growth of a full table, rounded up to a power of 2
+#define DIC_MIGRATE_STEP 16     // entries moved to the grown table by each insertion
+#define DIC_CHUNK_MIN 4096      // bytes of the first arena chunk, each next one doubles
+#define DIC_CHUNK_MAX 1048576   // cap on the size of an arena chunk
+
+// Open addressing swiss table keyed by pointers. Each slot has a control byte,
+// either DIC_EMPTY or the low 7 bits of the key hash, so a probe compares a
+// whole group of slots at once and only touches the slots whose byte matches.
+// Slots only hold the position of their entry: keys and values are stored
+// densely in insertion order, so iteration costs O(count). Each group of
+// control bytes is stamped with the generation that last wrote it, groups
+// of an older generation read as empty, so a reset only bumps the generation.
+struct dic_table {
+	int8_t *ctrl;              // length bytes, valid in groups stamped with the current generation
+	uint16_t *group_gen;       // length / DIC_GROUP generation stamps
+	uint16_t generation;       // never 0, which marks groups never written
+	int32_t *slots;            // length slots, entry index of full slots
+	void **keys;               // growth_limit entries, by insertion order
+	HASHDICT_VALUE_TYPE *values;
+	int length;                // power of 2, at least DIC_GROUP (0 until first built)
+	int growth_limit;          // entries at which the table grows, 7/8 of length
+};
+
+// Up to DIC_SMALL entries are kept in arrays inside the dictionary and found
+// with a SIMD compare of the keys, the table is only built (or, after a reset,
+// reused) past that. A full table is not rehashed at once: the entries move to
+// the grown one DIC_MIGRATE_STEP at a time on later insertions, and lookups
+// check both tables meanwhile. Values pointing to variable sized data can take
+// it from the dictionary arena: chunks bump allocated, rewound by a reset and
+// freed all at once with the dictionary.
+struct dic_chunk {
+	struct dic_chunk *next;
+	size_t size;            // bytes of data
+	_Alignas(16) char data[];
 };
-		
+
 struct dictionary {
-	struct keynode **table;
-	int length, count;
-	double growth_treshold;
-	double growth_factor;
-	HASHDICT_VALUE_TYPE *value;
+	struct dic_table table;    // entries [0, migrated) and [migrate_end, count)
+	struct dic_table old;      // table being migrated from, entries [migrated, migrate_end)
+	int migrated, migrate_end; // both 0 when no migration is running
+	int count;
+	int growth_factor;         // DIC_GROWTH_FACTOR, may be changed at any time
+	bool small;                // entries are in the inline arrays
+	HASHDICT_VALUE_TYPE *value; // value slot of the last key added or found, valid until the next add
+	struct dic_chunk *chunks;  // arena chunks, in allocation order
+	struct dic_chunk *chunk;   // chunk being filled, NULL before the first
+	size_t chunk_used;         // bytes of chunk already handed out
+	void *small_keys[DIC_SMALL];
+	HASHDICT_VALUE_TYPE small_values[DIC_SMALL];
 };
 
 /* See README.md */
 
 struct dictionary* dic_new(int initial_size);
 void dic_delete(struct dictionary* dic);
-int dic_add(struct dictionary* dic, void *key, int keyn);
+void dic_reset(struct dictionary* dic);
+int dic_add(struct dictionary* dic, void *key, int keyn); // 1 found, 0 added, -1 out of memory
 int dic_find(struct dictionary* dic, void *key, int keyn);
 void dic_forEach(struct dictionary* dic, enumFunc f, void *user);
-#endif
\ No newline at end of file
+typedef void (*aheadFunc)(void *key, void *user);
+void dic_forEachAhead(struct dictionary* dic, enumFunc f, aheadFunc ahead, int distance, void *user);
+void* dic_alloc(struct dictionary* dic, size_t size); // 16-byte aligned, valid until the next reset
+#endif
@@ -0,0 +1,34 @@
+#ifndef DICT_CHAINED_H
+#define DICT_CHAINED_H
+#include <stdlib.h> /* malloc/calloc */
+#include <stdint.h> /* uint32_t */
+#include <string.h> /* memcpy/memcmp */
+#include <xmmintrin.h>
+
+typedef int (*chained_enumFunc)(void *key, int count, void* *value, void *user);
+
+#define CHAINED_VALUE_TYPE void* // we want to hold void*
+#define CHAINED_KEY_LENGTH_TYPE uint8_t
+
+struct chained_keynode {
+	struct chained_keynode *next;
+	unsigned char *key;
+	CHAINED_KEY_LENGTH_TYPE len;
+	CHAINED_VALUE_TYPE value;
+};
+		
+struct chained_dictionary {
+	struct chained_keynode **table;
+	int length, count;
+	double growth_treshold;
+	double growth_factor;
+	CHAINED_VALUE_TYPE *value;
+};
+
+struct chained_dictionary* chained_dic_new(int initial_size);
+void chained_dic_delete(struct chained_dictionary* dic);
+void chained_dic_reset(struct chained_dictionary* dic);
+int chained_dic_add(struct chained_dictionary* dic, void *key, int keyn);
+int chained_dic_find(struct chained_dictionary* dic, void *key, int keyn);
+void chained_dic_forEach(struct chained_dictionary* dic, chained_enumFunc f, void *user);
+#endif
\ No newline at end of file
@@ -4,10 +4,13 @@
 #include <stdbool.h>
 #include "version_types.h"
 
-// Node structure for the linked list
+#define LL_CHUNK 14  // Elements per node, so that a node fills two cache lines
+
+// Node structure for the unrolled linked list, holding up to LL_CHUNK elements in order
 typedef struct ll_node {
-    void *data;
     struct ll_node *next;
+    unsigned int count;         // Used entries of data, only the tail node is filled by appends
+    void *data[LL_CHUNK];
 } ll_node_t;
 
 // Linked list structure with head and tail for O(1) append
@@ -15,7 +18,8 @@ typedef struct ll {
     ll_node_t *head;
     ll_node_t *tail;
     size_t size;
-    version_lock lock;  // Lock for thread-safe operations
+    ll_node_t *spare;   // Emptied node kept for the next append, see ll_clear
+    park_lock lock;     // Lock for thread-safe operations
 } ll_t;
 
 /**
@@ -31,6 +35,12 @@ bool ll_init(ll_t *list);
  */
 void ll_destroy(ll_t *list);
 
+/**
+ * Empty the linked list, keeping one node for later appends
+ * @param list Pointer to the linked list to empty
+ */
+void ll_clear(ll_t *list);
+
 /**
  * Destroy the linked list, free all nodes, and call destructor on each data element
  * @param list Pointer to the linked list to destroy
@@ -39,7 +49,7 @@ void ll_destroy(ll_t *list);
 void ll_destroy_nested(ll_t *list, void (*destructor)(void *));
 
 /**
- * Append data to the end of the linked list in O(1) time
+ * Append data to the end of the linked list in O(1) time, allocating a node every LL_CHUNK elements
  * @param list Pointer to the linked list
  * @param data Data to append
  * @return true on success, false on failure
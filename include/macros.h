@@ -34,3 +34,24 @@
     #define unused(variable)
     #warning This compiler has no support for GCC attributes
 #endif
+
+/** Hint the processor that the caller is spin-waiting.
+**/
+#undef cpu_relax
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    #define cpu_relax() \
+        __builtin_ia32_pause()
+#else
+    #define cpu_relax()
+#endif
+
+/** Force inlining of a function, so that constant arguments specialize its body.
+**/
+#undef force_inline
+#ifdef __GNUC__
+    #define force_inline \
+        inline __attribute__((always_inline))
+#else
+    #define force_inline \
+        inline
+#endif
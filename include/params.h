@@ -1,3 +1,28 @@
 #pragma once
 
-#define LOCK_ARRAY_SIZE 2097152 // 1048576
\ No newline at end of file
+#define LOCK_ARRAY_SIZE 2097152 // 1048576
+#define LOCK_GRANULARITY 8      // bytes covered by one lock
+#define LOCK_RANGE_MIN 8        // striped reads covering at least this many locks check them in bulk
+
+#define BACKOFF_ATTEMPTS 4      // retries of a busy write lock before aborting
+#define BACKOFF_SPIN_BASE 32    // pauses per retry (first retry for exponential)
+#define BACKOFF_SPIN_MAX 4096   // cap on pauses per retry for exponential
+
+#define COMMIT_PREFETCH_DISTANCE 8 // entries ahead whose lock (or word) is prefetched in tm_end, 0 to disable
+
+#define PARK_SPIN 128           // polls of a busy internal lock before parking
+
+#define HUGE_PAGE_SIZE 2097152  // transparent huge page size
+
+#define TX_CACHE_SIZE 4         // ended transaction descriptors kept per thread for reuse
+
+#define SEGMENT_SHARDS 16       // per-thread lists of committed segments per region
+#define EPOCH_SHARDS 64         // per-thread counters of running transactions per region
+
+#ifndef TM_STATS
+#define TM_STATS 1              // 0 removes statistics collection at compile time
+#endif
+#define STATS_SHARDS 64         // per-thread counter shards per region
+
+#define TRACE_RINGS 64          // per-thread event rings per traced region
+#define TRACE_RING_SIZE 65536   // events kept per ring, power of 2
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "macros.h"
+#include "params.h"
+#include "shared_t.h"
+
+// Header of a segment allocated by tm_alloc, right before its data and padded to
+// the region alignment, so the segment of a start address is found in O(1)
+typedef struct segment {
+    struct segment* prev;       // doubly linked in a registry shard once committed,
+    struct segment* next;       // in the allocating transaction before
+    struct segment* retired;    // next in the limbo list once freed
+    struct shared_rgn* region;  // owner, segments of another region are rejected
+    size_t size;                // bytes of data
+    unsigned int shard;         // registry shard holding the segment
+} segment_t;
+
+// One shard of the committed segments, a thread always publishes to the same shard
+typedef struct segment_shard {
+    _Alignas(64) park_lock lock;
+    segment_t* head;
+} segment_shard;
+
+// Running transactions of the threads mapped to a shard, by epoch modulo 3
+typedef struct epoch_shard {
+    _Alignas(64) _Atomic long active[3];
+} epoch_shard;
+
+// Segments of a region: O(1) registration and removal, and epoch-based
+// reclamation. A freed segment waits in the limbo list of the epoch of its
+// freeing transaction until every transaction that began before that one
+// ended, so that a doomed transaction never reads released memory.
+typedef struct segment_registry {
+    segment_shard shards[SEGMENT_SHARDS];
+    epoch_shard epochs[EPOCH_SHARDS];
+    _Alignas(64) _Atomic uint64_t epoch;
+    version_lock advancing;             // held by the thread advancing the epoch
+    _Atomic(segment_t*) limbo[3];       // freed segments, by epoch modulo 3
+} segment_registry;
+
+segment_registry* segments_create(void);
+void segments_destroy(segment_registry* segments);
+
+void* segment_alloc(shared_rgn* region, size_t size);
+// 'data' must be the region start or an address returned by tm_alloc (of any region): the header
+// before it is read unchecked, so an interior or unrelated pointer is undefined behavior
+segment_t* segment_of(shared_rgn* region, void* data);
+void segment_release(segment_t* segment);
+
+void segments_publish(segment_registry* segments, segment_t* first, segment_t* last);
+void segments_remove(segment_registry* segments, segment_t* segment);
+void segments_retire(segment_registry* segments, segment_t* segment, uint64_t epoch);
+
+uint64_t epoch_enter(segment_registry* segments, unsigned int* shard);
+void epoch_exit(segment_registry* segments, unsigned int shard, uint64_t epoch);
+bool epoch_try_advance(segment_registry* segments);
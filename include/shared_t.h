@@ -2,20 +2,32 @@
 
 #include "version_types.h"
 #include "ll.h"
+#include "tm_ext.h"
+#include "tx_t.h"
 
 
-typedef struct {
-    version_lock* lock_region;
-    void* data_region;
-}segment;
+struct shared_rgn;
 
-typedef struct {
+// word-by-word transactional copy, instantiated per alignment (see 'tm_read' and 'tm_write')
+typedef bool (*word_access_fn)(struct shared_rgn* region, transaction_t* tx, void const* source, size_t size, void* target);
+
+typedef struct shared_rgn {
     global_counter global_version;
     void* start;
 
     size_t size;
     size_t align;
+    word_access_fn read_words;  // tm_read body specialized for align
+    word_access_fn write_words; // tm_write body specialized for align
 
     version_lock* locks;
-    struct ll* segments;
-} shared_rgn; // The type of a shared memory region
\ No newline at end of file
+    size_t lock_mask;           // lock_count - 1, lock_count is a power of 2
+    unsigned int lock_shift;    // log2 of the bytes covered by one lock
+    bool lock_striped;          // lock index is the granule index, no hashing
+    lock_range_check_fn lock_range_check; // vectorized check of consecutive locks
+    struct segment_registry* segments; // segments allocated by transactions, besides the first one
+
+    tm_options_t options;       // options the region was created with
+    struct stats_shard* stats;  // per-thread counters, NULL when not collected
+    struct trace_buffer* trace; // per-thread event rings, NULL when not traced
+} shared_rgn; // The type of a shared memory region
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+#include "macros.h"
+#include "params.h"
+#include "shared_t.h"
+#include "tx_t.h"
+#include "dict.h"
+
+// One shard of a region's counters; a thread always updates the same shard,
+// so the relaxed increments below stay on a cache line the thread owns
+typedef struct stats_shard {
+    _Alignas(64) _Atomic uint64_t commits_ro;
+    _Atomic uint64_t commits_rw;
+    _Atomic uint64_t aborts_ro;
+    _Atomic uint64_t aborts_rw;
+    _Atomic uint64_t aborts_by_cause[TM_ABORT_CAUSES];
+    _Atomic uint64_t read_set_sizes[TM_STATS_SIZE_BUCKETS];
+    _Atomic uint64_t write_set_sizes[TM_STATS_SIZE_BUCKETS];
+    _Atomic uint64_t allocs;
+    _Atomic uint64_t frees;
+    _Atomic uint64_t commit_ns;
+} stats_shard;
+
+stats_shard* stats_create(void);
+void stats_destroy(stats_shard* shards);
+void stats_sum(stats_shard* shards, tm_stats_t* out);
+stats_shard* stats_local(stats_shard* shards);
+
+#define stats_inc(counter, n) atomic_fetch_add_explicit(&(counter), (n), memory_order_relaxed)
+
+static inline unsigned int stats_size_bucket(int size){
+    unsigned int bucket = size <= 0 ? 0 : 32 - __builtin_clz((unsigned int)size);
+    return bucket < TM_STATS_SIZE_BUCKETS ? bucket : TM_STATS_SIZE_BUCKETS - 1;
+}
+
+// Everything below compiles to nothing with TM_STATS == 0, and costs one
+// predictable branch for regions created without the 'stats' option
+
+static inline uint64_t stats_clock(shared_rgn* unused(region)){
+#if TM_STATS
+    if (unlikely(region->stats != NULL)){
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    }
+#endif
+    return 0;
+}
+
+static inline void stats_end(shared_rgn* unused(region), transaction_t* unused(tx), bool unused(committed), tm_abort_cause_t unused(cause), uint64_t unused(start)){
+#if TM_STATS
+    if (likely(region->stats == NULL)){
+        return;
+    }
+    stats_shard* shard = stats_local(region->stats);
+    if (tx->read_only){
+        if (committed) stats_inc(shard->commits_ro, 1);
+        else stats_inc(shard->aborts_ro, 1);
+    } else {
+        if (committed) stats_inc(shard->commits_rw, 1);
+        else stats_inc(shard->aborts_rw, 1);
+        stats_inc(shard->read_set_sizes[stats_size_bucket(tx->read_set->count)], 1);
+        stats_inc(shard->write_set_sizes[stats_size_bucket(tx->write_set->count)], 1);
+        if (start != 0){
+            stats_inc(shard->commit_ns, stats_clock(region) - start);
+        }
+    }
+    if (!committed){
+        stats_inc(shard->aborts_by_cause[cause], 1);
+    }
+#endif
+}
+
+static inline void stats_alloc(shared_rgn* unused(region)){
+#if TM_STATS
+    if (unlikely(region->stats != NULL)){
+        stats_inc(stats_local(region->stats)->allocs, 1);
+    }
+#endif
+}
+
+static inline void stats_free(shared_rgn* unused(region)){
+#if TM_STATS
+    if (unlikely(region->stats != NULL)){
+        stats_inc(stats_local(region->stats)->frees, 1);
+    }
+#endif
+}
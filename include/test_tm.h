@@ -25,4 +25,17 @@ void* long_alloc_transaction(void* arg);
 void* mixed_transaction(void* arg);
 void* very_long_transaction(void* arg);
 
+// Extension checks
+void check_create_ex(void);
+#if defined(__x86_64__) || defined(__i386__)
+void check_lock_range(void);
+#endif
+void check_stats(void);
+void check_trace(void);
+void check_alignments(void);
+void check_restart(void);
+void check_large_write(void);
+void check_free(void);
+void check_owned_locks(void);
+
 #endif // TEST_TM_H
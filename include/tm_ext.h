@@ -0,0 +1,115 @@
+/**
+ * @file   tm_ext.h
+ *
+ * @section DESCRIPTION
+ *
+ * Extensions to the transaction manager interface declared in tm.h.
+ * Everything here is optional: a client that only uses tm.h gets the
+ * default behaviour of every option below.
+**/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tm.h>
+
+// -------------------------------------------------------------------------- //
+
+typedef enum {
+    TM_ENGINE_TL2 = 0, // Lazy (commit-time) locking with a global version clock
+} tm_engine_t;
+
+typedef enum {
+    TM_BACKOFF_NONE = 0,    // Abort as soon as a write lock is busy at commit
+    TM_BACKOFF_SPIN,        // Retry a busy write lock after a fixed spin
+    TM_BACKOFF_EXPONENTIAL, // Retry a busy write lock after an exponentially growing spin
+} tm_backoff_t;
+
+typedef enum {
+    TM_LOCK_MAP_HASHED = 0, // Words are spread over the lock table by a hash of their address
+    TM_LOCK_MAP_STRIPED,    // Consecutive granules map to consecutive locks, multi-word reads check them in bulk
+} tm_lock_mapping_t;
+
+typedef struct {
+    size_t       lock_count;       // Number of versioned locks in the lock table, power of 2
+    size_t       lock_granularity; // Number of bytes covered by one lock, power of 2
+    tm_lock_mapping_t lock_mapping; // How addresses are mapped to locks
+    tm_engine_t  engine;           // Concurrency control algorithm
+    tm_backoff_t backoff;          // Behaviour on a busy write lock at commit time
+    bool         huge_pages;       // Back the lock table and large segments with transparent huge pages
+    bool         stats;            // Collect per-region statistics (see 'tm_stats')
+    char const*  trace_path;       // Record transaction events, dumped here as a Chrome trace at 'tm_destroy' (NULL to disable)
+    int          trace_signal;     // Signal requesting an extra dump to '<trace_path>.<n>' (0 for none)
+} tm_options_t;
+
+typedef enum {
+    TM_ABORT_READ_LOCKED = 0, // A read found its lock held by a committing transaction
+    TM_ABORT_READ_STALE,      // A read found a version newer than the transaction snapshot
+    TM_ABORT_LOCK_ACQUIRE,    // Commit could not acquire a write lock
+    TM_ABORT_VALIDATION,      // Commit found a read overwritten by a concurrent commit
+    TM_ABORT_OTHER,           // Invalid access or out of memory
+    TM_ABORT_CAUSES
+} tm_abort_cause_t;
+
+#define TM_STATS_SIZE_BUCKETS 16 // Bucket b > 0 counts sets of [2^(b-1), 2^b) entries, the last one is open-ended
+
+typedef struct {
+    uint64_t commits_ro;                              // Committed read-only transactions
+    uint64_t commits_rw;                              // Committed read-write transactions
+    uint64_t aborts_ro;                               // Aborted read-only transactions
+    uint64_t aborts_rw;                               // Aborted read-write transactions
+    uint64_t aborts_by_cause[TM_ABORT_CAUSES];        // Aborts of both kinds, by cause
+    uint64_t read_set_sizes[TM_STATS_SIZE_BUCKETS];   // Read set sizes of ended read-write transactions
+    uint64_t write_set_sizes[TM_STATS_SIZE_BUCKETS];  // Write set sizes of ended read-write transactions
+    uint64_t allocs;                                  // Successful 'tm_alloc' calls
+    uint64_t frees;                                   // Successful 'tm_free' calls
+    uint64_t commit_ns;                               // Time spent in 'tm_end' by read-write transactions
+} tm_stats_t;
+
+// -------------------------------------------------------------------------- //
+
+/** Fill the given options with the values used by 'tm_create'.
+ * @param options Options to initialize
+**/
+void tm_options_default(tm_options_t* options);
+
+/** Create (i.e. allocate + init) a new shared memory region, tuned by the given options.
+ * @param size    Size of the first shared segment of memory to allocate (in bytes), must be a positive multiple of the alignment
+ * @param align   Alignment (in bytes, must be a power of 2) that the shared memory region must support
+ * @param options Tuning options, NULL for the defaults of 'tm_create'
+ * @return Opaque shared memory region handle, 'invalid_shared' on failure (including invalid options)
+**/
+shared_t tm_create_ex(size_t size, size_t align, tm_options_t const* options);
+
+/** [thread-safe] Restart an ended transaction in place, with a fresh snapshot and the given mode.
+ * After an abort (or a commit), the calling thread keeps the last few transaction descriptors
+ * with their read/write set storage, and 'tm_begin' reuses them too, so the descriptor may have
+ * run in the other mode since 'tx' ended. The handle must not be used again if this returns
+ * false: call 'tm_begin' instead.
+ * @param shared Shared memory region associated with the transaction
+ * @param tx     Transaction that ended on the calling thread
+ * @param is_ro  Whether the restarted transaction is read-only
+ * @return Whether the transaction restarted
+**/
+bool tm_restart(shared_t shared, tx_t tx, bool is_ro);
+
+/** [thread-safe] Read the statistics of a region created with the 'stats' option.
+ * Counters are sharded per thread and summed here, so a snapshot taken while
+ * transactions run is not atomic across counters.
+ * @param shared Shared memory region to query
+ * @param out    Statistics to fill
+ * @return Whether statistics are available (collected and not compiled out)
+**/
+bool tm_stats(shared_t shared, tm_stats_t* out);
+
+/** [thread-safe] Write the events recorded so far by a region created with a 'trace_path'.
+ * The output is a Chrome trace (JSON) that chrome://tracing and Perfetto can open.
+ * Events recorded while dumping may be missing or torn.
+ * @param shared Shared memory region to dump
+ * @param path   File to write
+ * @return Whether tracing is enabled and the file was written
+**/
+bool tm_trace_dump(shared_t shared, char const* path);
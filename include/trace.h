@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "macros.h"
+#include "params.h"
+#include "shared_t.h"
+
+typedef enum {
+    TRACE_BEGIN = 0,      // transaction started
+    TRACE_READ_ABORT,     // tm_read found a locked or too recent word
+    TRACE_LOCK_FAIL,      // commit could not acquire a write lock
+    TRACE_VALIDATE_FAIL,  // commit found a read overwritten by a concurrent commit
+    TRACE_ABORT,          // any other abort
+    TRACE_COMMIT,         // transaction committed
+} trace_event_type;
+
+// Fixed-size binary event, converted to JSON only when dumping
+typedef struct {
+    uint64_t tsc;       // timestamp counter at record time
+    uintptr_t tx;       // transaction handle
+    uint32_t lock;      // lock table index involved, or UINT32_MAX
+    int32_t version;    // observed lock word on aborts, write version on commits
+    uint32_t type;      // trace_event_type
+} trace_event;
+
+// Single ring, written by the threads mapped to it (normally exactly one)
+typedef struct {
+    _Alignas(64) _Atomic uint64_t head; // number of events ever recorded
+    trace_event events[TRACE_RING_SIZE];
+} trace_ring;
+
+typedef struct trace_buffer {
+    _Atomic(trace_ring*) rings[TRACE_RINGS]; // allocated on first use by a thread slot
+    uint64_t tsc_origin;        // tsc when tracing started
+    uint64_t ns_origin;         // CLOCK_MONOTONIC when tracing started
+    _Atomic unsigned int dump_requests; // signal dump requests already served
+    int signal_number;          // dump signal handled for this buffer, 0 for none
+} trace_buffer;
+
+trace_buffer* trace_create(int signal_number);
+void trace_destroy(trace_buffer* trace);
+bool trace_dump(trace_buffer* trace, shared_rgn* region, char const* path);
+void trace_record_slow(shared_rgn* region, trace_event_type type, uintptr_t tx, version_lock* lock, int32_t version);
+
+// Record one event; a region without tracing pays only this predictable branch
+static inline void trace_record(shared_rgn* region, trace_event_type type, uintptr_t tx, version_lock* lock, int32_t version){
+    if (unlikely(region->trace != NULL)){
+        trace_record_slow(region, type, tx, lock, version);
+    }
+}
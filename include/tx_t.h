@@ -4,14 +4,22 @@
 #include <dict.h>
 #include <ll.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef struct {
     int read_version;
     int write_version;
+    int lock_tag;   // value of the locks held while committing, see lock_owner_tag
     
     bool read_only; // if transaction will only perform reads
 
     struct dictionary* read_set;    // is set
-    struct dictionary* write_set;   // is dict
-    struct ll* alloc_set;   // if alloc_set value is NULL, it has already been freed
+    struct dictionary* write_set;   // is dict, values are copies taken from its arena
+    struct dictionary* unique_locks; // locks of the write set, only used while committing
+    struct segment* allocs;      // segments allocated by the transaction, newest first
+    struct segment* allocs_last; // oldest one, to publish the whole chain at once
+    struct ll* free_set;         // segments to free at commit
+
+    uint64_t epoch;              // reclamation epoch the transaction runs in
+    unsigned int epoch_shard;
 }transaction_t; 
\ No newline at end of file
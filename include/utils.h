@@ -17,13 +17,19 @@ int unlock_unique_lock_set_until(void *key, int count, void* *value, void *user)
 int validate_reading_set(void *key, int count, void* *value, void *user);
 int write_writing_set(void *key, int count, void* *value, void *user);
 int update_unique_lock_set(void *key, int count, void* *value, void *user);
+void prefetch_unique_lock(void *key, void *user);
+void prefetch_reading_lock(void *key, void *user);
+void prefetch_writing_word(void *key, void *user);
 
 
-int nested_free_value_dict(void *key, int count, void* *value, void *user);
 int add_from_dict(void *key, int count, void* *value, void *user);
-int rm_from_dict(void *key, int count, void* *value, void *user);
-void dic_nested_destroy(struct dictionary*);
+unsigned int thread_slot(void);
+void backoff_wait(tm_backoff_t policy, unsigned int attempt);
+
+transaction_t* tx_create(void);
 void tx_destroy(transaction_t*, bool);
+void tx_retire(transaction_t*, bool);
+transaction_t* tx_reuse(transaction_t*);
 
 version_lock* lock_get_from_pointer(shared_rgn* shared, void* ptr);
 
@@ -11,6 +11,38 @@ bool lock_try_acquire(version_lock*);
 void lock_acquire(version_lock*);
 void lock_release(version_lock*);
 bool lock_check(version_lock*, int);
-bool lock_check_version(version_lock* lk, int own_vl);
 void lock_update_and_release(version_lock* lk, int updated_version);
 
+// While a committing transaction holds a lock, the lock word is the owner tag instead of the
+// version: bit 0 set, bit 1 (LOCK_STALE) set when the version it replaced was newer than the
+// owner's snapshot, so the owner validates its own locks with one compare
+#define LOCK_STALE 0x2
+
+static inline int lock_owner_tag(unsigned int owner){
+    return (int)((owner + 1) << 2) | 0x1;
+}
+
+bool lock_try_acquire_owned(version_lock* lk, int tag, int own_vl, int* previous);
+void lock_restore(version_lock* lk, int previous);
+bool lock_check_owned(version_lock* lk, int tag, int own_vl);
+
+
+#include <stddef.h>
+
+// First lock of [first, first + count) that is locked or newer than own_vl, NULL if none
+typedef version_lock* (*lock_range_check_fn)(version_lock* first, size_t count, int own_vl);
+
+version_lock* lock_check_range_scalar(version_lock* first, size_t count, int own_vl);
+#if defined(__x86_64__) || defined(__i386__)
+version_lock* lock_check_range_sse2(version_lock* first, size_t count, int own_vl);
+version_lock* lock_check_range_avx2(version_lock* first, size_t count, int own_vl);
+#endif
+lock_range_check_fn lock_check_range_select(void);
+
+// Mutex for short internal critical sections (segment lists, ll_t): spins PARK_SPIN
+// times, then parks the thread on a futex so that waiters do not burn the timeslice
+// of a preempted holder
+typedef _Atomic int park_lock; // 0 free, 1 held, 2 held with parked waiters
+
+void park_lock_acquire(park_lock*);
+void park_lock_release(park_lock*);